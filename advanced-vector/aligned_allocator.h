@@ -0,0 +1,189 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cstdint>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+// Выделяет блоки, выровненные по Alignment байт (по умолчанию по кэш-линии),
+// чтобы SIMD-код мог использовать выровненные загрузки с begin() вектора
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+    static constexpr size_t ALIGNMENT = std::max(Alignment, alignof(T));
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>& /*other*/) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(BytesFor(n), std::align_val_t(ALIGNMENT)));
+    }
+
+    void deallocate(T* p, size_t /*n*/) noexcept {
+        ::operator delete(p, std::align_val_t(ALIGNMENT));
+    }
+
+    friend bool operator==(const AlignedAllocator&, const AlignedAllocator&) noexcept {
+        return true;
+    }
+
+    friend bool operator!=(const AlignedAllocator&, const AlignedAllocator&) noexcept {
+        return false;
+    }
+
+    static size_t BytesFor(size_t n) {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+};
+
+// Буферы от Threshold байт отображаются через mmap на huge-страницы: сначала
+// пробуется MAP_HUGETLB, а если зарезервированных страниц нет, берутся обычные
+// страницы, выровненные по 2 МиБ, с подсказкой MADV_HUGEPAGE. Такие буферы растут
+// через mremap без копирования. Меньшие буферы и системы без mmap обслуживает AlignedAllocator
+template <typename T, size_t Alignment = 64, size_t Threshold = (size_t{2} << 20)>
+struct HugePageAllocator {
+    static constexpr size_t HUGE_PAGE_SIZE = size_t{2} << 20;
+
+    static_assert(Alignment <= HUGE_PAGE_SIZE, "Mapped buffers are only aligned to the huge page size");
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = HugePageAllocator<U, Alignment, Threshold>;
+    };
+
+    HugePageAllocator() = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, Alignment, Threshold>& /*other*/) noexcept {}
+
+    T* allocate(size_t n) {
+        const size_t bytes = Small::BytesFor(n);
+        return IsMapped(bytes) ? static_cast<T*>(Map(bytes)) : Small().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (IsMapped(n * sizeof(T))) {
+            Unmap(p, n * sizeof(T));
+        } else {
+            Small().deallocate(p, n);
+        }
+    }
+
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        const size_t old_bytes = old_n * sizeof(T);
+        const size_t new_bytes = Small::BytesFor(new_n);
+
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+        if (IsMapped(old_bytes) && IsMapped(new_bytes)) {
+            void* new_p = mremap(p, MappedLength(old_bytes), MappedLength(new_bytes), MREMAP_MAYMOVE);
+            if (new_p != MAP_FAILED) {
+                Advise(new_p, MappedLength(new_bytes));
+                return static_cast<T*>(new_p);
+            }
+        }
+#endif
+
+        T* new_p = allocate(new_n);
+        std::memcpy(static_cast<void*>(new_p), static_cast<const void*>(p), std::min(old_bytes, new_bytes));
+        deallocate(p, old_n);
+        return new_p;
+    }
+
+    friend bool operator==(const HugePageAllocator&, const HugePageAllocator&) noexcept {
+        return true;
+    }
+
+    friend bool operator!=(const HugePageAllocator&, const HugePageAllocator&) noexcept {
+        return false;
+    }
+
+private:
+    using Small = AlignedAllocator<T, Alignment>;
+
+    static bool IsMapped(size_t bytes) noexcept {
+#if defined(__linux__)
+        return bytes >= Threshold;
+#else
+        (void)bytes;
+        return false;
+#endif
+    }
+
+    static size_t MappedLength(size_t bytes) noexcept {
+        return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    }
+
+#if defined(__linux__)
+    static void* Map(size_t bytes) {
+        const size_t length = MappedLength(bytes);
+        if (length < bytes) {
+            throw std::bad_array_new_length();
+        }
+
+        const int prot = PROT_READ | PROT_WRITE;
+        const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+#if defined(MAP_HUGETLB)
+        void* huge = mmap(nullptr, length, prot, flags | MAP_HUGETLB, -1, 0);
+        if (huge != MAP_FAILED) {
+            return huge;
+        }
+#endif
+
+        // Отображаем с запасом и обрезаем края, чтобы начало попало на границу huge-страницы
+        char* raw = static_cast<char*>(mmap(nullptr, length + HUGE_PAGE_SIZE, prot, flags, -1, 0));
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+
+        const size_t head = -reinterpret_cast<uintptr_t>(raw) & (HUGE_PAGE_SIZE - 1);
+        if (head != 0) {
+            munmap(raw, head);
+        }
+        munmap(raw + head + length, HUGE_PAGE_SIZE - head);
+
+        Advise(raw + head, length);
+        return raw + head;
+    }
+
+    static void Unmap(void* p, size_t bytes) noexcept {
+        munmap(p, MappedLength(bytes));
+    }
+
+    // Подсказка необязательна: без THP память просто останется на обычных страницах
+    static void Advise(void* p, size_t length) noexcept {
+#if defined(MADV_HUGEPAGE)
+        madvise(p, length, MADV_HUGEPAGE);
+#else
+        (void)p;
+        (void)length;
+#endif
+    }
+#else
+    static void* Map(size_t /*bytes*/) {
+        throw std::bad_alloc();
+    }
+
+    static void Unmap(void* /*p*/, size_t /*bytes*/) noexcept {}
+#endif
+};
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cstdint>
+
+// Монотонная арена: память выделяется сдвигом указателя внутри блоков и
+// освобождается целиком при уничтожении арены. Арена не потокобезопасна,
+// пользоваться ею должен тот поток, который её создал
+class Arena {
+public:
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena() {
+        while (chunks_ != nullptr) {
+            ReleaseChunk(std::exchange(chunks_, chunks_->next));
+        }
+    }
+
+    void* Allocate(size_t bytes, size_t alignment) {
+        assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+        size_t padding = chunks_ != nullptr ? Padding(top_, alignment) : 0;
+        if (chunks_ == nullptr || bytes + padding > static_cast<size_t>(chunks_->End() - top_)) {
+            PushChunk(bytes + alignment);
+            padding = Padding(top_, alignment);
+        }
+
+        last_ = top_ + padding;
+        top_ = last_ + bytes;
+        return last_;
+    }
+
+    // Меняет размер последнего выделенного блока, если ему хватает места в текущем блоке
+    bool TryResize(void* p, size_t new_bytes) noexcept {
+        if (p == nullptr || p != last_ || new_bytes > static_cast<size_t>(chunks_->End() - last_)) {
+            return false;
+        }
+
+        top_ = last_ + new_bytes;
+        return true;
+    }
+
+    // Арена самой внутренней активной ArenaScope этого потока или nullptr
+    static Arena* Current() noexcept {
+        return current_;
+    }
+
+private:
+    friend class ArenaScope;
+
+    struct alignas(std::max_align_t) Chunk {
+        Chunk* next;
+        size_t size;
+
+        char* Begin() noexcept {
+            return reinterpret_cast<char*>(this + 1);
+        }
+
+        char* End() noexcept {
+            return Begin() + size;
+        }
+    };
+
+    // Блоки стандартного размера, освобождённые аренами потока, ждут следующую арену
+    struct ChunkCache {
+        static constexpr size_t MAX_CHUNKS = 16;
+
+        ~ChunkCache() {
+            while (head != nullptr) {
+                ::operator delete(std::exchange(head, head->next));
+            }
+        }
+
+        Chunk* head = nullptr;
+        size_t count = 0;
+    };
+
+    static ChunkCache& Cache() noexcept {
+        thread_local ChunkCache cache;
+        return cache;
+    }
+
+    static size_t Padding(const char* p, size_t alignment) noexcept {
+        return -reinterpret_cast<uintptr_t>(p) & (alignment - 1);
+    }
+
+    void PushChunk(size_t min_bytes) {
+        Chunk* chunk = nullptr;
+
+        ChunkCache& cache = Cache();
+
+        if (min_bytes <= CHUNK_SIZE && cache.head != nullptr) {
+            chunk = std::exchange(cache.head, cache.head->next);
+            --cache.count;
+        } else {
+            const size_t size = std::max(min_bytes, CHUNK_SIZE);
+            if (size > static_cast<size_t>(-1) - sizeof(Chunk)) {
+                throw std::bad_array_new_length();
+            }
+            chunk = static_cast<Chunk*>(::operator new(sizeof(Chunk) + size));
+            chunk->size = size;
+        }
+
+        chunk->next = chunks_;
+        chunks_ = chunk;
+        top_ = chunk->Begin();
+        last_ = nullptr;
+    }
+
+    static void ReleaseChunk(Chunk* chunk) noexcept {
+        ChunkCache& cache = Cache();
+
+        if (chunk->size == CHUNK_SIZE && cache.count < ChunkCache::MAX_CHUNKS) {
+            chunk->next = cache.head;
+            cache.head = chunk;
+            ++cache.count;
+        } else {
+            ::operator delete(chunk);
+        }
+    }
+
+    Chunk* chunks_ = nullptr;   // текущий блок, за ним заполненные ранее
+    char* top_ = nullptr;
+    char* last_ = nullptr;      // начало последнего выделенного блока
+
+    inline static thread_local Arena* current_ = nullptr;
+};
+
+// Пока объект жив, аллокаторы ArenaAllocator, созданные в этом потоке, берут память
+// из его арены. Вся память арены освобождается при выходе из области видимости,
+// поэтому векторы, использующие её, не должны пережить ArenaScope
+class ArenaScope {
+public:
+    ArenaScope() noexcept
+        : previous_(std::exchange(Arena::current_, &arena_))
+    {}
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    ~ArenaScope() {
+        assert(Arena::current_ == &arena_);
+        Arena::current_ = previous_;
+    }
+
+    Arena& GetArena() noexcept {
+        return arena_;
+    }
+
+private:
+    Arena arena_;
+    Arena* previous_;
+};
+
+// Аллокатор запоминает арену, активную в момент его создания. Вне ArenaScope
+// он работает как обычный operator new. deallocate внутри арены ничего не делает
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept
+        : arena_(Arena::Current())
+    {}
+
+    explicit ArenaAllocator(Arena* arena) noexcept
+        : arena_(arena)
+    {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : arena_(other.GetArena())
+    {}
+
+    // Копия вектора принадлежит той области, где её создали, а не арене оригинала
+    ArenaAllocator select_on_container_copy_construction() const noexcept {
+        return ArenaAllocator();
+    }
+
+    T* allocate(size_t n) {
+        if (arena_ == nullptr) {
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T*>(arena_->Allocate(BytesFor(n), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (arena_ == nullptr) {
+            std::allocator<T>().deallocate(p, n);
+        }
+    }
+
+    // Последний выделенный в арене буфер растёт на месте, остальные копируются
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        if (arena_ != nullptr && arena_->TryResize(p, BytesFor(new_n))) {
+            return p;
+        }
+
+        T* new_p = allocate(new_n);
+        std::memcpy(static_cast<void*>(new_p), static_cast<const void*>(p), std::min(old_n, new_n) * sizeof(T));
+        deallocate(p, old_n);
+        return new_p;
+    }
+
+    Arena* GetArena() const noexcept {
+        return arena_;
+    }
+
+    template <typename U>
+    friend bool operator==(const ArenaAllocator& lhs, const ArenaAllocator<U>& rhs) noexcept {
+        return lhs.arena_ == rhs.GetArena();
+    }
+
+    template <typename U>
+    friend bool operator!=(const ArenaAllocator& lhs, const ArenaAllocator<U>& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    static size_t BytesFor(size_t n) {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+
+    Arena* arena_;
+};
@@ -0,0 +1,420 @@
+#pragma once
+
+#include "vector.h"
+
+// Число элементов в куске по умолчанию: степень двойки, при которой кусок занимает
+// около 64 КиБ, но не меньше одного элемента
+template <typename T>
+constexpr size_t ChunkedVectorDefaultChunk() noexcept {
+    size_t chunk = 1;
+    while (chunk * 2 * sizeof(T) <= (size_t{1} << 16)) {
+        chunk *= 2;
+    }
+    return chunk;
+}
+
+// Вектор из кусков RawMemory по ChunkSize элементов и небольшой таблицы кусков.
+// При росте добавляется новый кусок, а уже созданные элементы никогда не переезжают,
+// поэтому ссылки и указатели на них остаются действительными до удаления самих
+// элементов, а стоимость добавления не зависит от размера вектора.
+// Итераторы хранят адрес таблицы и становятся недействительными, когда она растёт.
+// Удаление с конца и с начала освобождает опустевшие куски целиком
+template <typename T, typename Alloc = std::allocator<T>, size_t ChunkSize = ChunkedVectorDefaultChunk<T>()>
+class ChunkedVector {
+    static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "The chunk size must be a power of two");
+
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using Chunk = RawMemory<T, Alloc>;
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+
+    static constexpr size_t CHUNK_SIZE = ChunkSize;
+
+    template <bool IsConst>
+    class BasicIterator {
+        using ChunkPointer = std::conditional_t<IsConst, const Chunk*, Chunk*>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+
+        BasicIterator() = default;
+
+        BasicIterator(ChunkPointer chunks, size_t position, size_t last) noexcept
+            : chunks_(chunks)
+            , position_(position)
+            , last_(last)
+        {}
+
+        operator BasicIterator<true>() const noexcept {
+            return BasicIterator<true>(chunks_, position_, last_);
+        }
+
+        reference operator*() const noexcept {
+            return *Get();
+        }
+
+        pointer operator->() const noexcept {
+            return Get();
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return *(*this + offset);
+        }
+
+        // Конец непрерывного участка, на котором стоит итератор. Алгоритм может
+        // обработать [&*it, it.ChunkEnd()) как обычный массив и перейти к следующему куску.
+        // В последнем куске участок обрывается на последнем элементе, а не на конце куска
+        pointer ChunkEnd() const noexcept {
+            return Get() + std::min(ChunkSize - position_ % ChunkSize, last_ - position_);
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++position_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            return BasicIterator(chunks_, position_++, last_);
+        }
+
+        BasicIterator& operator--() noexcept {
+            --position_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            return BasicIterator(chunks_, position_--, last_);
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept {
+            position_ += offset;
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type offset) noexcept {
+            position_ -= offset;
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.position_) - static_cast<difference_type>(rhs.position_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.position_ == rhs.position_;
+        }
+
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.position_ != rhs.position_;
+        }
+
+        friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.position_ < rhs.position_;
+        }
+
+        friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.position_ <= rhs.position_;
+        }
+
+        friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.position_ > rhs.position_;
+        }
+
+        friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.position_ >= rhs.position_;
+        }
+
+    private:
+        pointer Get() const noexcept {
+            return chunks_[position_ / ChunkSize].GetAddress() + position_ % ChunkSize;
+        }
+
+        ChunkPointer chunks_ = nullptr;
+        // Позиция считается от начала первого куска, а не от первого элемента
+        size_t position_ = 0;
+        // Позиция за последним элементом на момент создания итератора
+        size_t last_ = 0;
+    };
+
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+
+    ChunkedVector() = default;
+
+    explicit ChunkedVector(const Alloc& alloc) noexcept
+        : alloc_(alloc)
+    {}
+
+    explicit ChunkedVector(size_t size, const Alloc& alloc = Alloc())
+        : ChunkedVector(alloc)
+    {
+        Resize(size);
+    }
+
+    ChunkedVector(const ChunkedVector& other)
+        : ChunkedVector(AllocTraits::select_on_container_copy_construction(other.alloc_))
+    {
+        Reserve(other.size_);
+        other.ForEachChunk([this](const T* first, const T* last) {
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+        });
+    }
+
+    ChunkedVector(ChunkedVector&& other) noexcept
+        : alloc_(std::move(other.alloc_))
+        , chunks_(std::move(other.chunks_))
+        , front_(std::exchange(other.front_, 0))
+        , size_(std::exchange(other.size_, 0))
+    {}
+
+    ChunkedVector& operator=(const ChunkedVector& rhs) {
+        if (this != &rhs) {
+            ChunkedVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    ChunkedVector& operator=(ChunkedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            ChunkedVector rhs_copy(std::move(rhs));
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    ~ChunkedVector() {
+        DestroyRange(front_, front_ + size_);
+    }
+
+    void Swap(ChunkedVector& other) noexcept {
+        using std::swap;
+        swap(alloc_, other.alloc_);
+        chunks_.Swap(other.chunks_);
+        swap(front_, other.front_);
+        swap(size_, other.size_);
+    }
+
+    iterator begin() noexcept {
+        return iterator(chunks_.begin(), front_, front_ + size_);
+    }
+
+    iterator end() noexcept {
+        return iterator(chunks_.begin(), front_ + size_, front_ + size_);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(chunks_.begin(), front_, front_ + size_);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(chunks_.begin(), front_ + size_, front_ + size_);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    bool Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Сколько элементов поместится без выделения новых кусков
+    size_t Capacity() const noexcept {
+        return chunks_.Size() * ChunkSize - front_;
+    }
+
+    size_t ChunkCount() const noexcept {
+        return chunks_.Size();
+    }
+
+    Alloc GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return *At(front_ + index);
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<ChunkedVector&>(*this)[index];
+    }
+
+    // Вызывает f(first, last) для каждого непрерывного участка элементов по порядку
+    template <typename F>
+    void ForEachChunk(F f) {
+        ForEachRun(front_, front_ + size_, [&f](T* first, T* last) {
+            f(first, last);
+        });
+    }
+
+    template <typename F>
+    void ForEachChunk(F f) const {
+        const_cast<ChunkedVector&>(*this).ForEachRun(front_, front_ + size_, [&f](const T* first, const T* last) {
+            f(first, last);
+        });
+    }
+
+    void Reserve(size_t new_capacity) {
+        const size_t required = ChunksFor(front_ + new_capacity);
+        if (required > chunks_.Size()) {
+            chunks_.Reserve(required);
+            while (chunks_.Size() < required) {
+                chunks_.EmplaceBack(ChunkSize, alloc_);
+            }
+        }
+    }
+
+    // Освобождает куски, в которых нет элементов
+    void ShrinkToFit() {
+        ReleaseChunksAfter(front_ + size_, 0);
+    }
+
+    // Строгая гарантия. Элементы уже в векторе не переезжают, поэтому value может
+    // ссылаться на один из них
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        const size_t position = front_ + size_;
+        if (position == chunks_.Size() * ChunkSize) {
+            // Если конструктор бросит исключение, новый кусок останется запасным
+            chunks_.EmplaceBack(ChunkSize, alloc_);
+        }
+
+        T* slot = At(position);
+        new (slot) T(std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    template <typename Value>
+    void PushBack(Value&& value) {
+        EmplaceBack(std::forward<Value>(value));
+    }
+
+    // Один пустой кусок за концом остаётся в запасе, чтобы чередование PushBack
+    // и PopBack на границе не выделяло и не освобождало память каждый раз
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        std::destroy_at(At(front_ + size_));
+        ReleaseChunksAfter(front_ + size_, 1);
+    }
+
+    // Удаляет count первых элементов и освобождает опустевшие куски начала.
+    // Остальные элементы не переезжают
+    void EraseFront(size_t count) noexcept {
+        assert(count <= size_);
+        DestroyRange(front_, front_ + count);
+        front_ += count;
+        size_ -= count;
+
+        const size_t empty_chunks = front_ / ChunkSize;
+        if (empty_chunks != 0) {
+            chunks_.Erase(chunks_.begin(), chunks_.begin() + empty_chunks);
+            front_ -= empty_chunks * ChunkSize;
+        }
+        if (size_ == 0) {
+            front_ = 0;
+        }
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size <= size_) {
+            DestroyRange(front_ + new_size, front_ + size_);
+            size_ = new_size;
+            ReleaseChunksAfter(front_ + size_, 1);
+            return;
+        }
+
+        Reserve(new_size);
+        const size_t old_size = size_;
+        try {
+            while (size_ < new_size) {
+                new (At(front_ + size_)) T();
+                ++size_;
+            }
+        } catch (...) {
+            DestroyRange(front_ + old_size, front_ + size_);
+            size_ = old_size;
+            throw;
+        }
+    }
+
+    // Уничтожает элементы, сохраняя куски
+    void Clear() noexcept {
+        DestroyRange(front_, front_ + size_);
+        size_ = 0;
+        front_ = 0;
+    }
+
+private:
+    static size_t ChunksFor(size_t positions) noexcept {
+        return (positions + ChunkSize - 1) / ChunkSize;
+    }
+
+    T* At(size_t position) noexcept {
+        return chunks_[position / ChunkSize].GetAddress() + position % ChunkSize;
+    }
+
+    // Вызывает f(first, last) для участков позиций [from, to), лежащих в одном куске
+    template <typename F>
+    void ForEachRun(size_t from, size_t to, F f) {
+        while (from < to) {
+            const size_t run_end = std::min(to, (from / ChunkSize + 1) * ChunkSize);
+            T* first = At(from);
+            f(first, first + (run_end - from));
+            from = run_end;
+        }
+    }
+
+    void DestroyRange(size_t from, size_t to) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            ForEachRun(from, to, [](T* first, T* last) {
+                std::destroy(first, last);
+            });
+        }
+    }
+
+    // Оставляет spare пустых кусков после куска с позицией end - 1
+    void ReleaseChunksAfter(size_t end, size_t spare) noexcept {
+        const size_t keep = ChunksFor(end) + spare;
+        while (chunks_.Size() > keep) {
+            chunks_.PopBack();
+        }
+    }
+
+    [[no_unique_address]] Alloc alloc_;
+    Vector<Chunk> chunks_;
+    // Позиция первого элемента в первом куске
+    size_t front_ = 0;
+    size_t size_ = 0;
+};
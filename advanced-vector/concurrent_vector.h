@@ -0,0 +1,193 @@
+#pragma once
+
+#include "vector.h"
+
+#include <atomic>
+
+// Вектор, в который несколько потоков одновременно добавляют элементы без блокировок.
+// Память состоит из сегментов размером FIRST_SEGMENT, 2 * FIRST_SEGMENT, 4 * FIRST_SEGMENT...
+// Существующие элементы никогда не переезжают, поэтому ссылки на них остаются
+// действительными до уничтожения вектора. Индекс слота занимается одним fetch_add,
+// а готовность элемента отмечается флагом слота: читатели других потоков видят
+// элемент только после того, как его конструктор завершился.
+// Одновременно с добавлением можно читать элементы, но не вызывать Clear и деструктор
+template <typename T, typename Alloc = std::allocator<T>, size_t FirstSegment = 64>
+class ConcurrentVector {
+    static_assert(FirstSegment > 0 && (FirstSegment & (FirstSegment - 1)) == 0,
+                  "The first segment size must be a power of two");
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+
+    static constexpr size_t FIRST_SEGMENT = FirstSegment;
+
+    ConcurrentVector() = default;
+
+    explicit ConcurrentVector(const Alloc& alloc) noexcept
+        : alloc_(alloc)
+    {}
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    ~ConcurrentVector() {
+        Clear();
+    }
+
+    // Число занятых слотов. Элемент слота может быть ещё не сконструирован, см. TryGet
+    size_t Size() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        const size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+        return Construct(index, std::forward<Args>(args)...);
+    }
+
+    template <typename Value>
+    T& PushBack(Value&& value) {
+        return EmplaceBack(std::forward<Value>(value));
+    }
+
+    // Занимает count подряд идущих слотов, конструирует в них элементы по умолчанию
+    // и возвращает индекс первого. Соседние слоты могут лежать в разных сегментах
+    size_t GrowBy(size_t count) {
+        const size_t first = size_.fetch_add(count, std::memory_order_relaxed);
+        for (size_t index = first; index < first + count; ++index) {
+            Construct(index);
+        }
+        return first;
+    }
+
+    // Элемент слота index или nullptr, если он ещё не сконструирован либо его
+    // конструктор бросил исключение
+    T* TryGet(size_t index) noexcept {
+        const Location location = Locate(index);
+        Segment* segment = segments_[location.segment].load(std::memory_order_acquire);
+        if (segment == nullptr
+            || segment->states[location.offset].load(std::memory_order_acquire) != READY) {
+            return nullptr;
+        }
+        return segment->elements.GetAddress() + location.offset;
+    }
+
+    const T* TryGet(size_t index) const noexcept {
+        return const_cast<ConcurrentVector&>(*this).TryGet(index);
+    }
+
+    // Доступ к элементу, про который известно, что он готов,
+    // например после завершения всех пишущих потоков
+    T& operator[](size_t index) noexcept {
+        T* element = TryGet(index);
+        assert(element != nullptr);
+        return *element;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<ConcurrentVector&>(*this)[index];
+    }
+
+    // Уничтожает элементы и освобождает сегменты. Не потокобезопасен
+    void Clear() noexcept {
+        for (size_t k = 0; k < MAX_SEGMENTS; ++k) {
+            Segment* segment = segments_[k].exchange(nullptr, std::memory_order_acquire);
+            if (segment == nullptr) {
+                continue;
+            }
+            for (size_t offset = 0; offset < SegmentSize(k); ++offset) {
+                if (segment->states[offset].load(std::memory_order_relaxed) == READY) {
+                    std::destroy_at(segment->elements.GetAddress() + offset);
+                }
+            }
+            delete segment;
+        }
+        size_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    enum SlotState : unsigned char {
+        EMPTY,
+        READY,
+        FAILED,
+    };
+
+    struct Segment {
+        Segment(size_t size, const Alloc& alloc)
+            : elements(size, alloc)
+            , states(new std::atomic<unsigned char>[size]())
+        {}
+
+        RawMemory<T, Alloc> elements;
+        std::unique_ptr<std::atomic<unsigned char>[]> states;
+    };
+
+    struct Location {
+        size_t segment;
+        size_t offset;
+    };
+
+    static constexpr size_t FIRST_SHIFT = [] {
+        size_t shift = 0;
+        while ((size_t{1} << shift) < FirstSegment) {
+            ++shift;
+        }
+        return shift;
+    }();
+
+    // Сегменты покрывают все индексы, представимые в size_t
+    static constexpr size_t MAX_SEGMENTS = 8 * sizeof(size_t) - FIRST_SHIFT;
+
+    static constexpr size_t SegmentSize(size_t k) noexcept {
+        return FirstSegment << k;
+    }
+
+    // Сегмент k начинается с индекса FirstSegment * (2^k - 1)
+    static Location Locate(size_t index) noexcept {
+        const size_t scaled = (index >> FIRST_SHIFT) + 1;
+        size_t k = 0;
+        while ((scaled >> (k + 1)) != 0) {
+            ++k;
+        }
+        return {k, index - ((SegmentSize(k)) - FirstSegment)};
+    }
+
+    template <typename... Args>
+    T& Construct(size_t index, Args&&... args) {
+        const Location location = Locate(index);
+        Segment& segment = GetSegment(location.segment);
+        T* slot = segment.elements.GetAddress() + location.offset;
+
+        try {
+            new (slot) T(std::forward<Args>(args)...);
+        } catch (...) {
+            // Слот остаётся пустым навсегда: индекс уже мог быть занят следующими элементами
+            segment.states[location.offset].store(FAILED, std::memory_order_release);
+            throw;
+        }
+
+        segment.states[location.offset].store(READY, std::memory_order_release);
+        return *slot;
+    }
+
+    // Сегмент выделяет первый поток, которому он понадобился. Проигравшие гонку
+    // освобождают свою копию и пользуются опубликованной
+    Segment& GetSegment(size_t k) {
+        Segment* segment = segments_[k].load(std::memory_order_acquire);
+        if (segment != nullptr) {
+            return *segment;
+        }
+
+        auto created = std::make_unique<Segment>(SegmentSize(k), alloc_);
+        if (segments_[k].compare_exchange_strong(segment, created.get(), std::memory_order_acq_rel,
+                                                 std::memory_order_acquire)) {
+            return *created.release();
+        }
+        return *segment;
+    }
+
+    [[no_unique_address]] Alloc alloc_;
+    std::atomic<Segment*> segments_[MAX_SEGMENTS] = {};
+    std::atomic<size_t> size_ = 0;
+};
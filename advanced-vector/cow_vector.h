@@ -0,0 +1,232 @@
+#pragma once
+
+#include "vector.h"
+
+#include <atomic>
+
+// Вектор с копированием при записи. Копии разделяют один буфер со счётчиком ссылок,
+// поэтому копирование и передача снимка другому потоку стоят O(1). Первый неконстантный
+// доступ к разделяемому буферу делает личную копию элементов.
+// Разные копии можно использовать в разных потоках одновременно: константный доступ
+// не блокирует и не пишет ничего общего. Один объект CowVector, как и Vector,
+// нельзя менять одновременно из нескольких потоков.
+// Ссылки, полученные через неконстантный доступ, следует считать недействительными
+// после копирования вектора: копия разделит с ним буфер, и запись через старую ссылку
+// станет видна в копии
+template <typename T, typename Alloc = std::allocator<T>>
+class CowVector {
+    struct Block {
+        explicit Block(Vector<T, Alloc> elements) noexcept
+            : data(std::move(elements))
+        {}
+
+        std::atomic<size_t> refs = 1;
+        Vector<T, Alloc> data;
+    };
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    CowVector() = default;
+
+    explicit CowVector(size_t size)
+        : block_(size != 0 ? new Block(Vector<T, Alloc>(size)) : nullptr)
+    {}
+
+    CowVector(std::initializer_list<T> init)
+        : block_(init.size() != 0 ? new Block(Vector<T, Alloc>(init)) : nullptr)
+    {}
+
+    // Забирает буфер vector без копирования элементов
+    explicit CowVector(Vector<T, Alloc>&& vector)
+        : block_(vector.Size() != 0 ? new Block(std::move(vector)) : nullptr)
+    {}
+
+    CowVector(const CowVector& other) noexcept
+        : block_(other.block_)
+    {
+        if (block_ != nullptr) {
+            block_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CowVector(CowVector&& other) noexcept
+        : block_(std::exchange(other.block_, nullptr))
+    {}
+
+    CowVector& operator=(const CowVector& rhs) noexcept {
+        if (this != &rhs) {
+            CowVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    CowVector& operator=(CowVector&& rhs) noexcept {
+        if (this != &rhs) {
+            CowVector rhs_copy(std::move(rhs));
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    ~CowVector() {
+        Unref(block_);
+    }
+
+    void Swap(CowVector& other) noexcept {
+        std::swap(block_, other.block_);
+    }
+
+    // Снимок текущего содержимого, разделяющий с вектором буфер
+    CowVector Snapshot() const noexcept {
+        return *this;
+    }
+
+    // Число векторов, разделяющих буфер, включая этот; 0 для пустого буфера
+    size_t UseCount() const noexcept {
+        return block_ != nullptr ? block_->refs.load(std::memory_order_acquire) : 0;
+    }
+
+    const_iterator begin() const noexcept {
+        return block_ != nullptr ? block_->data.begin() : nullptr;
+    }
+
+    const_iterator end() const noexcept {
+        return block_ != nullptr ? block_->data.end() : nullptr;
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // Неконстантные итераторы делают буфер личным
+    iterator begin() {
+        return block_ != nullptr ? Mutable().begin() : nullptr;
+    }
+
+    iterator end() {
+        return block_ != nullptr ? Mutable().end() : nullptr;
+    }
+
+    size_t Size() const noexcept {
+        return block_ != nullptr ? block_->data.Size() : 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return block_ != nullptr ? block_->data.Capacity() : 0;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return block_->data[index];
+    }
+
+    T& operator[](size_t index) {
+        assert(index < Size());
+        return Mutable()[index];
+    }
+
+    // Содержимое без копирования, даже если буфер общий. Ссылка действительна
+    // до следующего изменяющего вызова: он может заменить буфер собственной копией
+    const Vector<T, Alloc>& View() const noexcept {
+        static const Vector<T, Alloc> empty;
+        return block_ != nullptr ? block_->data : empty;
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > Capacity()) {
+            Mutable(new_capacity).Reserve(new_capacity);
+        }
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size != Size()) {
+            Mutable(new_size).Resize(new_size);
+        }
+    }
+
+    // Отпускает разделяемый буфер, не копируя его
+    void Clear() noexcept {
+        if (block_ != nullptr && block_->refs.load(std::memory_order_acquire) == 1) {
+            block_->data.Clear();
+        } else {
+            Unref(std::exchange(block_, nullptr));
+        }
+    }
+
+    // Строгая гарантия. value может ссылаться на элемент этого вектора или его снимка:
+    // общий буфер отпускается только после того, как элемент построен в личной копии
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (block_ == nullptr || block_->refs.load(std::memory_order_acquire) == 1) {
+            return Mutable().EmplaceBack(std::forward<Args>(args)...);
+        }
+
+        const size_t size = Size();
+        Vector<T, Alloc> copy = SharedCopy(Growth::NewCapacity(size, size + 1, sizeof(T)));
+        copy.EmplaceBack(std::forward<Args>(args)...);
+        Unref(std::exchange(block_, new Block(std::move(copy))));
+        return block_->data[size];
+    }
+
+    template <typename Value>
+    void PushBack(Value&& value) {
+        EmplaceBack(std::forward<Value>(value));
+    }
+
+    void PopBack() {
+        assert(Size() != 0);
+        Mutable().PopBack();
+    }
+
+    iterator Erase(const_iterator pos) {
+        const size_t offset = pos - cbegin();
+        Vector<T, Alloc>& data = Mutable();
+        return data.Erase(data.begin() + offset);
+    }
+
+private:
+    using Growth = typename Vector<T, Alloc>::growth_policy;
+
+    // Копия общего буфера ёмкостью не меньше min_capacity, чтобы следующая
+    // запись не выделяла память второй раз
+    Vector<T, Alloc> SharedCopy(size_t min_capacity) const {
+        const Vector<T, Alloc>& shared = block_->data;
+        if (min_capacity <= shared.Size()) {
+            return shared;
+        }
+        Vector<T, Alloc> copy(std::allocator_traits<Alloc>::select_on_container_copy_construction(shared.GetAllocator()));
+        copy.Reserve(min_capacity);
+        copy.Append(shared.begin(), shared.end());
+        return copy;
+    }
+
+    // Личный буфер для записи. Копия делается до того, как отпускается общий буфер,
+    // поэтому при исключении вектор остаётся прежним
+    Vector<T, Alloc>& Mutable(size_t min_capacity = 0) {
+        if (block_ == nullptr) {
+            block_ = new Block(Vector<T, Alloc>());
+        } else if (block_->refs.load(std::memory_order_acquire) != 1) {
+            Vector<T, Alloc> copy = SharedCopy(min_capacity);
+            Unref(std::exchange(block_, new Block(std::move(copy))));
+        }
+        return block_->data;
+    }
+
+    // Последний владелец видит все записи остальных благодаря acq_rel
+    static void Unref(Block* block) noexcept {
+        if (block != nullptr && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete block;
+        }
+    }
+
+    Block* block_ = nullptr;
+};
@@ -0,0 +1,774 @@
+#include "small_vector.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Дифференциальный тест: длинные случайные последовательности операций над Vector
+// и SmallVector повторяются над std::vector, а каждая операция прогоняется с отказом на первом,
+// втором, третьем и т.д. конструкторе или выделении памяти, пока не пройдёт целиком.
+// После каждой попытки сверяются содержимое, число живых объектов и выделенная память,
+// а после отказа операций со строгой гарантией вектор должен остаться прежним.
+// Сборка: g++ -std=c++17 -O1 -g -fsanitize=address,undefined -fno-sanitize-recover=all fuzz_test.cpp -o fuzz_test
+// Флаги: --seed=N (по умолчанию 1), --runs=N (20), --steps=N (2000)
+// С -DADVANCED_VECTOR_LIBFUZZER и clang -fsanitize=fuzzer,address,undefined операции
+// берутся из входа libFuzzer
+
+namespace {
+
+struct FuzzContext {
+    uint64_t seed = 0;
+    size_t step = 0;
+};
+
+FuzzContext context;
+
+[[noreturn]] void Fail(const char* what, int line) {
+    std::fprintf(stderr, "fuzz_test.cpp:%d: check failed: %s (seed %llu, step %zu)\n", line, what,
+                 static_cast<unsigned long long>(context.seed), context.step);
+    std::abort();
+}
+
+#define FUZZ_CHECK(condition) ((condition) ? void() : Fail(#condition, __LINE__))
+
+struct InjectedFault : std::runtime_error {
+    InjectedFault()
+        : std::runtime_error("Injected fault")
+    {}
+};
+
+// Точки отказа: конструкторы элементов и выделения памяти. Arm(n) заставляет n-ю
+// точку после вызова отказать
+struct Faults {
+    static void Arm(size_t countdown) noexcept {
+        remaining = countdown;
+    }
+
+    static void Disarm() noexcept {
+        remaining = 0;
+    }
+
+    static bool Hit() noexcept {
+        return remaining != 0 && --remaining == 0;
+    }
+
+    static inline size_t remaining = 0;
+};
+
+struct Census {
+    static inline long alive = 0;
+};
+
+enum class MoveKind {
+    NOTHROW,
+    THROWING,
+    // Конструктор перемещения не вызывается вовсе: элементы переносятся memcpy
+    RELOCATABLE,
+};
+
+inline constexpr int MOVED_FROM = -1;
+inline constexpr uint32_t ALIVE_COOKIE = 0xfeedbeef;
+
+template <MoveKind Kind>
+class FuzzObj {
+    static constexpr bool NOTHROW_MOVE = Kind != MoveKind::THROWING;
+
+public:
+    explicit FuzzObj(int value = 0)
+        : value_(value)
+    {
+        Construct();
+    }
+
+    FuzzObj(const FuzzObj& other)
+        : value_(other.Value())
+    {
+        Construct();
+    }
+
+    FuzzObj(FuzzObj&& other) noexcept(NOTHROW_MOVE)
+        : value_(other.Value())
+    {
+        if constexpr (NOTHROW_MOVE) {
+            MarkAlive();
+        } else {
+            Construct();
+        }
+        other.value_ = MOVED_FROM;
+    }
+
+    FuzzObj& operator=(const FuzzObj& rhs) {
+        FUZZ_CHECK(IsAlive());
+        if (Faults::Hit()) {
+            throw InjectedFault();
+        }
+        value_ = rhs.Value();
+        return *this;
+    }
+
+    FuzzObj& operator=(FuzzObj&& rhs) noexcept(NOTHROW_MOVE) {
+        FUZZ_CHECK(IsAlive());
+        if constexpr (!NOTHROW_MOVE) {
+            if (Faults::Hit()) {
+                throw InjectedFault();
+            }
+        }
+        value_ = std::exchange(rhs.value_, MOVED_FROM);
+        return *this;
+    }
+
+    ~FuzzObj() {
+        FUZZ_CHECK(IsAlive());
+        cookie_ = 0;
+        --Census::alive;
+    }
+
+    int Value() const noexcept {
+        FUZZ_CHECK(IsAlive());
+        return value_;
+    }
+
+private:
+    void Construct() {
+        if (Faults::Hit()) {
+            throw InjectedFault();
+        }
+        MarkAlive();
+    }
+
+    void MarkAlive() noexcept {
+        cookie_ = ALIVE_COOKIE;
+        ++Census::alive;
+    }
+
+    bool IsAlive() const noexcept {
+        return cookie_ == ALIVE_COOKIE;
+    }
+
+    int value_;
+    uint32_t cookie_ = 0;
+};
+
+}  // namespace
+
+template <>
+struct IsTriviallyRelocatable<FuzzObj<MoveKind::RELOCATABLE>> : std::true_type {};
+
+namespace {
+
+int ValueOf(int value) noexcept {
+    return value;
+}
+
+template <MoveKind Kind>
+int ValueOf(const FuzzObj<Kind>& obj) noexcept {
+    return obj.Value();
+}
+
+// Все живые блоки всех FaultyAllocator с их размерами в байтах
+struct Heap {
+    static size_t LiveBytes() noexcept {
+        size_t bytes = 0;
+        for (const auto& [block, size] : blocks) {
+            bytes += size;
+        }
+        return bytes;
+    }
+
+    static inline std::map<void*, size_t> blocks;
+};
+
+// Аллокатор, который отказывает по команде Faults и проверяет, что каждый блок
+// освобождается ровно один раз и с тем же размером, с каким выделялся
+template <typename T, bool Reallocating>
+struct FaultyAllocator {
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = FaultyAllocator<U, Reallocating>;
+    };
+
+    FaultyAllocator() = default;
+
+    template <typename U>
+    FaultyAllocator(const FaultyAllocator<U, Reallocating>& /*other*/) noexcept {}
+
+    T* allocate(size_t n) {
+        if (Faults::Hit()) {
+            throw std::bad_alloc();
+        }
+        void* block = std::malloc(n * sizeof(T));
+        FUZZ_CHECK(block != nullptr);
+        FUZZ_CHECK(Heap::blocks.emplace(block, n * sizeof(T)).second);
+        return static_cast<T*>(block);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        const auto it = Heap::blocks.find(p);
+        FUZZ_CHECK(it != Heap::blocks.end() && it->second == n * sizeof(T));
+        Heap::blocks.erase(it);
+        std::free(p);
+    }
+
+    // Как realloc: при отказе прежний блок остаётся нетронутым
+    template <bool R = Reallocating, typename = std::enable_if_t<R>>
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        if (Faults::Hit()) {
+            throw std::bad_alloc();
+        }
+        const auto it = Heap::blocks.find(p);
+        FUZZ_CHECK(it != Heap::blocks.end() && it->second == old_n * sizeof(T));
+        Heap::blocks.erase(it);
+        void* block = std::realloc(static_cast<void*>(p), new_n * sizeof(T));
+        FUZZ_CHECK(block != nullptr);
+        Heap::blocks.emplace(block, new_n * sizeof(T));
+        return static_cast<T*>(block);
+    }
+
+    friend bool operator==(const FaultyAllocator&, const FaultyAllocator&) noexcept {
+        return true;
+    }
+
+    friend bool operator!=(const FaultyAllocator&, const FaultyAllocator&) noexcept {
+        return false;
+    }
+};
+
+// Источник решений: генератор случайных чисел или байты от libFuzzer
+class Choices {
+public:
+    explicit Choices(uint64_t seed)
+        : random_(seed)
+    {}
+
+    Choices(const uint8_t* data, size_t size)
+        : data_(data)
+        , size_(size)
+        , from_bytes_(true)
+    {}
+
+    bool Done() const noexcept {
+        return from_bytes_ && position_ >= size_;
+    }
+
+    // Число из [0, bound)
+    size_t Next(size_t bound) {
+        if (!from_bytes_) {
+            return std::uniform_int_distribution<size_t>(0, bound - 1)(random_);
+        }
+        size_t value = 0;
+        for (size_t range = 1; range < bound && position_ < size_; range <<= 8) {
+            value = (value << 8) | data_[position_++];
+        }
+        return value % bound;
+    }
+
+private:
+    std::mt19937_64 random_;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t position_ = 0;
+    bool from_bytes_ = false;
+};
+
+// Встроенный буфер SmallVector в тесте: меньше MAX_SIZE, чтобы векторы переходили в кучу
+inline constexpr size_t INLINE_CAPACITY = 8;
+inline constexpr size_t MAX_SIZE = 96;
+inline constexpr size_t MAX_RANGE = 8;
+inline constexpr int MAX_VALUE = 1000;
+
+enum class Guarantee {
+    STRONG,
+    BASIC,
+};
+
+template <typename Vec>
+struct IsSmallVector : std::false_type {};
+
+template <typename T, size_t N, typename Alloc, typename Growth>
+struct IsSmallVector<SmallVector<T, N, Alloc, Growth>> : std::true_type {};
+
+template <typename T, typename Alloc, typename Growth>
+size_t HeapBytes(const Vector<T, Alloc, Growth>& v) noexcept {
+    return v.Capacity() * sizeof(T);
+}
+
+// Пока элементы во встроенном буфере, SmallVector не должен держать память в куче
+template <typename T, size_t N, typename Alloc, typename Growth>
+size_t HeapBytes(const SmallVector<T, N, Alloc, Growth>& v) noexcept {
+    return v.IsInline() ? 0 : v.Capacity() * sizeof(T);
+}
+
+// Пара векторов и их модели: операции над двумя векторами проверяют копирование,
+// перемещение и обмен
+template <typename Vec>
+class Differential {
+    using T = typename Vec::value_type;
+    using Model = std::vector<int>;
+
+    static constexpr bool COUNTED = !std::is_same_v<T, int>;
+    static constexpr bool NOTHROW_MOVE = std::is_nothrow_move_constructible_v<T>
+                                         && std::is_nothrow_move_assignable_v<T>;
+    // У SmallVector нет удаления диапазонов, вставки диапазонов и ShrinkToFit:
+    // эти шаги для него пропускаются
+    static constexpr bool FULL_INTERFACE = !IsSmallVector<Vec>::value;
+
+public:
+    ~Differential() {
+        // SmallVector, которому присвоили пустой вектор, оставляет себе буфер в куче,
+        // поэтому векторы перемещаются во временные объекты
+        for (Vec& v : vectors_) {
+            Vec released(std::move(v));
+        }
+        FUZZ_CHECK(Census::alive == 0);
+        FUZZ_CHECK(Heap::blocks.empty());
+    }
+
+    void Step(Choices& choices) {
+        const size_t target = choices.Next(2);
+        const size_t other = 1 - target;
+        Vec& v = vectors_[target];
+        Model& m = models_[target];
+
+        // Позиции и длины выбираются заранее и приводятся к текущему размеру при каждой
+        // попытке: после отказа с базовой гарантией размер мог измениться
+        const size_t raw_pos = choices.Next(MAX_SIZE + 1);
+        const size_t raw_count = choices.Next(MAX_RANGE + 1);
+        const int value = static_cast<int>(choices.Next(MAX_VALUE));
+        auto pos = [&]() {
+            return raw_pos % (v.Size() + 1);
+        };
+        auto element = [&]() {
+            return raw_pos % v.Size();
+        };
+        auto count = [&]() {
+            return std::min(raw_count, v.Size() - pos());
+        };
+        auto source = [&]() {
+            std::vector<T> values;
+            for (size_t i = 0; i < raw_count; ++i) {
+                values.emplace_back(value + static_cast<int>(i));
+            }
+            return values;
+        };
+        auto source_model = [&]() {
+            Model values;
+            for (size_t i = 0; i < raw_count; ++i) {
+                values.push_back(value + static_cast<int>(i));
+            }
+            return values;
+        };
+        // Вставка в середину без перевыделения сдвигает элементы присваиванием
+        const Guarantee insert_guarantee = NOTHROW_MOVE ? Guarantee::STRONG : Guarantee::BASIC;
+        // SmallVector перемещает и обменивает встроенные элементы поштучно
+        const Guarantee move_guarantee = FULL_INTERFACE || NOTHROW_MOVE ? Guarantee::STRONG : Guarantee::BASIC;
+        const bool can_grow = v.Size() < MAX_SIZE;
+
+        switch (choices.Next(24)) {
+        case 0:
+            if (can_grow) {
+                Run(Guarantee::STRONG, [&] {
+                    const T item(value);
+                    v.PushBack(item);
+                }, [&] {
+                    m.push_back(value);
+                });
+            }
+            break;
+        case 1:
+            if (can_grow && !m.empty()) {
+                Run(Guarantee::STRONG, [&] {
+                    v.PushBack(v[element()]);
+                }, [&] {
+                    m.push_back(m[raw_pos % m.size()]);
+                });
+            }
+            break;
+        case 2:
+            if (can_grow) {
+                Run(Guarantee::STRONG, [&] {
+                    v.EmplaceBack(value);
+                }, [&] {
+                    m.push_back(value);
+                });
+            }
+            break;
+        case 3:
+            if (can_grow) {
+                Run(Guarantee::STRONG, [&] {
+                    v.PushBack(T(value));
+                }, [&] {
+                    m.push_back(value);
+                });
+            }
+            break;
+        case 4:
+            if (!m.empty()) {
+                Run(Guarantee::STRONG, [&] {
+                    v.PopBack();
+                }, [&] {
+                    m.pop_back();
+                });
+            }
+            break;
+        case 5:
+            if (can_grow) {
+                Run(insert_guarantee, [&] {
+                    v.Insert(v.begin() + pos(), T(value));
+                }, [&] {
+                    m.insert(m.begin() + raw_pos % (m.size() + 1), value);
+                });
+            }
+            break;
+        case 6:
+            if (can_grow && !m.empty()) {
+                Run(insert_guarantee, [&] {
+                    v.Insert(v.begin() + pos(), v[element()]);
+                }, [&] {
+                    const int item = m[raw_pos % m.size()];
+                    m.insert(m.begin() + raw_pos % (m.size() + 1), item);
+                });
+            }
+            break;
+        case 7:
+            if (can_grow) {
+                Run(insert_guarantee, [&] {
+                    v.Emplace(v.begin() + pos(), value);
+                }, [&] {
+                    m.insert(m.begin() + raw_pos % (m.size() + 1), value);
+                });
+            }
+            break;
+        case 8:
+            if (!m.empty()) {
+                Run(Guarantee::BASIC, [&] {
+                    v.Erase(v.begin() + element());
+                }, [&] {
+                    m.erase(m.begin() + raw_pos % m.size());
+                });
+            }
+            break;
+        case 9:
+            if constexpr (FULL_INTERFACE) {
+                Run(Guarantee::BASIC, [&] {
+                    v.Erase(v.begin() + pos(), v.begin() + pos() + count());
+                }, [&] {
+                    const size_t first = raw_pos % (m.size() + 1);
+                    m.erase(m.begin() + first, m.begin() + first + std::min(raw_count, m.size() - first));
+                });
+            }
+            break;
+        case 10:
+            if constexpr (FULL_INTERFACE) {
+                if (!m.empty()) {
+                    Run(Guarantee::BASIC, [&] {
+                        v.SwapErase(v.begin() + element());
+                    }, [&] {
+                        UnorderedErase(m, raw_pos % m.size(), 1);
+                    });
+                }
+            }
+            break;
+        case 11:
+            if constexpr (FULL_INTERFACE) {
+                Run(Guarantee::BASIC, [&] {
+                    v.UnorderedErase(v.begin() + pos(), v.begin() + pos() + count());
+                }, [&] {
+                    const size_t first = raw_pos % (m.size() + 1);
+                    UnorderedErase(m, first, std::min(raw_count, m.size() - first));
+                });
+            }
+            break;
+        case 12: {
+            const int divisor = static_cast<int>(raw_count) + 2;
+            if constexpr (FULL_INTERFACE) {
+                Run(Guarantee::BASIC, [&] {
+                    v.EraseIf([divisor](const T& item) {
+                        return ValueOf(item) % divisor == 0;
+                    });
+                }, [&] {
+                    m.erase(std::remove_if(m.begin(), m.end(), [divisor](int item) {
+                        return item % divisor == 0;
+                    }), m.end());
+                });
+            }
+            break;
+        }
+        case 13:
+            if constexpr (FULL_INTERFACE) {
+                if (can_grow) {
+                    Run(Guarantee::BASIC, [&] {
+                        const std::vector<T> values = source();
+                        v.Insert(v.begin() + pos(), values.begin(), values.end());
+                    }, [&] {
+                        const Model values = source_model();
+                        m.insert(m.begin() + raw_pos % (m.size() + 1), values.begin(), values.end());
+                    });
+                }
+            }
+            break;
+        case 14:
+            if constexpr (FULL_INTERFACE) {
+                if (can_grow) {
+                    Run(Guarantee::BASIC, [&] {
+                        const std::vector<T> values = source();
+                        v.Append(values.begin(), values.end());
+                    }, [&] {
+                        const Model values = source_model();
+                        m.insert(m.end(), values.begin(), values.end());
+                    });
+                }
+            }
+            break;
+        case 15:
+            if constexpr (FULL_INTERFACE) {
+                Run(Guarantee::BASIC, [&] {
+                    const std::vector<T> values = source();
+                    v.Assign(values.begin(), values.end());
+                }, [&] {
+                    m = source_model();
+                });
+            }
+            break;
+        case 16:
+            Run(Guarantee::STRONG, [&] {
+                v.Resize(raw_pos);
+            }, [&] {
+                m.resize(raw_pos);
+            });
+            break;
+        case 17:
+            Run(Guarantee::STRONG, [&] {
+                v.Reserve(raw_pos);
+            }, [] {});
+            break;
+        case 18:
+            if constexpr (FULL_INTERFACE) {
+                Run(Guarantee::STRONG, [&] {
+                    v.ShrinkToFit();
+                }, [] {});
+            }
+            break;
+        case 19:
+            Run(Guarantee::STRONG, [&] {
+                v.Clear();
+            }, [&] {
+                m.clear();
+            });
+            break;
+        case 20: {
+            // Присваивание через ссылку проверяет и самоприсваивание
+            const Vec& rhs = vectors_[raw_count % 2 == 0 ? other : target];
+            Run(Guarantee::BASIC, [&] {
+                v = rhs;
+            }, [&] {
+                m = models_[&rhs == &v ? target : other];
+            });
+            break;
+        }
+        case 21:
+            Run(move_guarantee, [&] {
+                Vec copy(vectors_[other]);
+                v = std::move(copy);
+            }, [&] {
+                m = models_[other];
+            });
+            break;
+        case 22:
+            Run(move_guarantee, [&] {
+                v = std::move(vectors_[other]);
+            }, [&] {
+                m = std::move(models_[other]);
+                models_[other].clear();
+            });
+            break;
+        case 23:
+            Run(move_guarantee, [&] {
+                v.Swap(vectors_[other]);
+            }, [&] {
+                m.swap(models_[other]);
+            });
+            break;
+        }
+    }
+
+private:
+    // Тот же порядок, что у Vector::UnorderedErase: в дыру переезжают последние элементы
+    static void UnorderedErase(Model& m, size_t offset, size_t count) {
+        const size_t moved = std::min(count, m.size() - offset - count);
+        Model result(m.begin(), m.begin() + offset);
+        result.insert(result.end(), m.end() - moved, m.end());
+        result.insert(result.end(), m.begin() + offset + count, m.end() - moved);
+        m = std::move(result);
+    }
+
+    // Повторяет операцию, пока она не пройдёт без отказа: n-я попытка отказывает
+    // на n-й точке отказа
+    template <typename Apply, typename Update>
+    void Run(Guarantee guarantee, Apply apply, Update update) {
+        for (size_t countdown = 1;; ++countdown) {
+            Faults::Arm(countdown);
+            try {
+                apply();
+                Faults::Disarm();
+                update();
+                CheckContents();
+                CheckResources();
+                return;
+            } catch (const InjectedFault&) {
+            } catch (const std::bad_alloc&) {
+            }
+
+            Faults::Disarm();
+            CheckResources();
+            if (guarantee == Guarantee::STRONG) {
+                CheckContents();
+            } else {
+                for (size_t i = 0; i < 2; ++i) {
+                    models_[i].assign(vectors_[i].Size(), 0);
+                    std::transform(vectors_[i].begin(), vectors_[i].end(), models_[i].begin(), [](const T& item) {
+                        return ValueOf(item);
+                    });
+                }
+            }
+        }
+    }
+
+    void CheckContents() const {
+        for (size_t i = 0; i < 2; ++i) {
+            FUZZ_CHECK(vectors_[i].Size() == models_[i].size());
+            for (size_t j = 0; j < models_[i].size(); ++j) {
+                FUZZ_CHECK(ValueOf(vectors_[i][j]) == models_[i][j]);
+            }
+        }
+    }
+
+    // Живые объекты и выделенная память в точности соответствуют размерам и ёмкостям
+    void CheckResources() const {
+        size_t elements = 0;
+        size_t bytes = 0;
+        for (const Vec& v : vectors_) {
+            FUZZ_CHECK(v.Size() <= v.Capacity());
+            elements += v.Size();
+            bytes += HeapBytes(v);
+        }
+        FUZZ_CHECK(Census::alive == (COUNTED ? static_cast<long>(elements) : 0));
+        FUZZ_CHECK(Heap::LiveBytes() == bytes);
+    }
+
+    Vec vectors_[2];
+    Model models_[2];
+};
+
+template <typename Vec>
+void RunSequence(Choices& choices, size_t max_steps) {
+    Differential<Vec> differential;
+    for (context.step = 0; context.step < max_steps && !choices.Done(); ++context.step) {
+        differential.Step(choices);
+    }
+}
+
+inline constexpr size_t CONFIGURATIONS = 8;
+
+// Конфигурации покрывают поэлементный перенос с noexcept и бросающим перемещением,
+// перенос memcpy с realloc для нетривиального типа, тривиальный тип с разными ростами
+// и те же три вида элементов в SmallVector
+void RunConfiguration(size_t configuration, Choices& choices, size_t max_steps) {
+    using NothrowObj = FuzzObj<MoveKind::NOTHROW>;
+    using ThrowingObj = FuzzObj<MoveKind::THROWING>;
+    using RelocatableObj = FuzzObj<MoveKind::RELOCATABLE>;
+
+    switch (configuration) {
+    case 0:
+        RunSequence<Vector<NothrowObj, FaultyAllocator<NothrowObj, false>>>(choices, max_steps);
+        break;
+    case 1:
+        RunSequence<Vector<ThrowingObj, FaultyAllocator<ThrowingObj, false>>>(choices, max_steps);
+        break;
+    case 2:
+        RunSequence<Vector<RelocatableObj, FaultyAllocator<RelocatableObj, true>>>(choices, max_steps);
+        break;
+    case 3:
+        RunSequence<Vector<int, FaultyAllocator<int, true>, ShrinkingGrowth<>>>(choices, max_steps);
+        break;
+    case 4:
+        RunSequence<Vector<int, FaultyAllocator<int, false>, OneAndHalfGrowth>>(choices, max_steps);
+        break;
+    case 5:
+        RunSequence<SmallVector<NothrowObj, INLINE_CAPACITY, FaultyAllocator<NothrowObj, false>>>(choices, max_steps);
+        break;
+    case 6:
+        RunSequence<SmallVector<ThrowingObj, INLINE_CAPACITY, FaultyAllocator<ThrowingObj, false>>>(choices,
+                                                                                                    max_steps);
+        break;
+    case 7:
+        RunSequence<SmallVector<RelocatableObj, INLINE_CAPACITY, FaultyAllocator<RelocatableObj, false>>>(
+            choices, max_steps);
+        break;
+    }
+}
+
+}  // namespace
+
+#ifdef ADVANCED_VECTOR_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    Choices choices(data + 1, size - 1);
+    RunConfiguration(data[0] % CONFIGURATIONS, choices, static_cast<size_t>(-1));
+    return 0;
+}
+
+#else
+
+namespace {
+
+bool ParseSize(std::string_view arg, std::string_view prefix, uint64_t& value) {
+    if (arg.substr(0, prefix.size()) != prefix) {
+        return false;
+    }
+    value = std::strtoull(std::string(arg.substr(prefix.size())).c_str(), nullptr, 10);
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace std::literals;
+
+    uint64_t seed = 1;
+    uint64_t runs = 20;
+    uint64_t steps = 2000;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (!ParseSize(arg, "--seed="sv, seed) && !ParseSize(arg, "--runs="sv, runs)
+            && !ParseSize(arg, "--steps="sv, steps)) {
+            std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    for (uint64_t run = 0; run < runs; ++run) {
+        for (size_t configuration = 0; configuration < CONFIGURATIONS; ++configuration) {
+            context.seed = seed + run;
+            Choices choices(context.seed * CONFIGURATIONS + configuration);
+            RunConfiguration(configuration, choices, steps);
+        }
+    }
+    std::printf("%llu runs of %llu steps passed\n", static_cast<unsigned long long>(runs),
+                static_cast<unsigned long long>(steps));
+}
+
+#endif
@@ -0,0 +1,551 @@
+#pragma once
+
+#include "vector.h"
+
+#include <atomic>
+#include <cstdint>
+
+// Неизменяемый вектор со структурным разделением. Элементы лежат в листьях по 32
+// в префиксном дереве с ветвлением 32, последние до 32 элементов хранятся отдельно
+// в хвосте. Set и PushBack возвращают новую версию за O(log32 n): копируется только
+// путь от корня к изменённому листу, остальные узлы общие со старой версией.
+// Узлы считают ссылки атомарно, поэтому версии можно свободно передавать между потоками.
+// Для пакетного построения есть Transient: он меняет на месте узлы, которые сам
+// создал, и копирует только общие с другими версиями
+template <typename T>
+class ImmutableVector {
+    static constexpr size_t BITS = 5;
+    static constexpr size_t WIDTH = size_t{1} << BITS;
+    static constexpr size_t MASK = WIDTH - 1;
+
+    struct Node {
+        explicit Node(uint64_t owner) noexcept
+            : owner(owner)
+        {}
+
+        std::atomic<size_t> refs = 1;
+        // Transient, которому разрешено менять узел на месте; 0, если никому
+        const uint64_t owner;
+    };
+
+    struct Inner : Node {
+        using Node::Node;
+
+        Node* children[WIDTH] = {};
+    };
+
+    struct Leaf : Node {
+        using Node::Node;
+
+        ~Leaf() {
+            std::destroy_n(Values(), count);
+        }
+
+        T* Values() noexcept {
+            return reinterpret_cast<T*>(storage);
+        }
+
+        size_t count = 0;
+        alignas(T) unsigned char storage[WIDTH * sizeof(T)];
+    };
+
+    // Корень и хвост общие для вектора и Transient. shift равен BITS * высоту дерева;
+    // пустой корень означает дерево без листьев
+    struct State {
+        Node* root = nullptr;
+        Node* tail = nullptr;
+        size_t size = 0;
+        size_t shift = BITS;
+    };
+
+public:
+    using value_type = T;
+
+    class Transient;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = const T&;
+        using pointer = const T*;
+
+        const_iterator() = default;
+
+        const_iterator(const ImmutableVector* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index)
+        {}
+
+        // Лист запоминается, и соседние элементы читаются без спуска по дереву
+        reference operator*() const noexcept {
+            if (leaf_ == nullptr || index_ - leaf_start_ >= WIDTH) {
+                leaf_start_ = index_ & ~MASK;
+                leaf_ = owner_->LeafFor(index_);
+            }
+            return leaf_[index_ - leaf_start_];
+        }
+
+        pointer operator->() const noexcept {
+            return &**this;
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return (*owner_)[index_ + offset];
+        }
+
+        const_iterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept {
+            const_iterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        const_iterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        const_iterator operator--(int) noexcept {
+            const_iterator old = *this;
+            --index_;
+            return old;
+        }
+
+        const_iterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        const_iterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend const_iterator operator+(const_iterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend const_iterator operator+(difference_type offset, const_iterator it) noexcept {
+            return it += offset;
+        }
+
+        friend const_iterator operator-(const_iterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator<=(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+            return lhs.index_ <= rhs.index_;
+        }
+
+        friend bool operator>(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+            return lhs.index_ > rhs.index_;
+        }
+
+        friend bool operator>=(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+            return lhs.index_ >= rhs.index_;
+        }
+
+    private:
+        const ImmutableVector* owner_ = nullptr;
+        size_t index_ = 0;
+        mutable const T* leaf_ = nullptr;
+        mutable size_t leaf_start_ = 0;
+    };
+
+    using iterator = const_iterator;
+
+    ImmutableVector() = default;
+
+    ImmutableVector(std::initializer_list<T> init)
+        : ImmutableVector(init.begin(), init.end())
+    {}
+
+    template <typename InputIt, typename = std::enable_if_t<IsInputIterator<InputIt>::value>>
+    ImmutableVector(InputIt first, InputIt last) {
+        Transient transient;
+        for (; first != last; ++first) {
+            transient.PushBack(*first);
+        }
+        *this = transient.Persistent();
+    }
+
+    // Строится через Transient за O(n)
+    template <typename... Policies>
+    explicit ImmutableVector(const Vector<T, Policies...>& vector)
+        : ImmutableVector(vector.begin(), vector.end())
+    {}
+
+    ImmutableVector(const ImmutableVector& other) noexcept
+        : state_(Retain(other.state_))
+    {}
+
+    ImmutableVector(ImmutableVector&& other) noexcept
+        : state_(std::exchange(other.state_, State()))
+    {}
+
+    ImmutableVector& operator=(const ImmutableVector& rhs) noexcept {
+        if (this != &rhs) {
+            ImmutableVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    ImmutableVector& operator=(ImmutableVector&& rhs) noexcept {
+        if (this != &rhs) {
+            ImmutableVector rhs_copy(std::move(rhs));
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    ~ImmutableVector() {
+        ReleaseState(state_);
+    }
+
+    void Swap(ImmutableVector& other) noexcept {
+        std::swap(state_, other.state_);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this, state_.size);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return state_.size;
+    }
+
+    bool Empty() const noexcept {
+        return state_.size == 0;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < state_.size);
+        return LeafFor(index)[index & MASK];
+    }
+
+    // Новая версия с value на месте index
+    template <typename Value>
+    [[nodiscard]] ImmutableVector Set(size_t index, Value&& value) const {
+        Transient transient(*this);
+        transient.Set(index, std::forward<Value>(value));
+        return transient.Persistent();
+    }
+
+    // Новая версия с элементом, сконструированным из args, в конце
+    template <typename... Args>
+    [[nodiscard]] ImmutableVector EmplaceBack(Args&&... args) const {
+        Transient transient(*this);
+        transient.EmplaceBack(std::forward<Args>(args)...);
+        return transient.Persistent();
+    }
+
+    template <typename Value>
+    [[nodiscard]] ImmutableVector PushBack(Value&& value) const {
+        return EmplaceBack(std::forward<Value>(value));
+    }
+
+    // Transient, начинающий с содержимого этой версии. Сама версия не меняется
+    Transient MakeTransient() const noexcept {
+        return Transient(*this);
+    }
+
+    // Вызывает f(first, last) для каждого листа по порядку
+    template <typename F>
+    void ForEachChunk(F f) const {
+        for (size_t start = 0; start < state_.size; start += WIDTH) {
+            const T* first = LeafFor(start);
+            f(first, first + std::min(WIDTH, state_.size - start));
+        }
+    }
+
+    template <typename Alloc = std::allocator<T>>
+    Vector<T, Alloc> ToVector() const {
+        Vector<T, Alloc> result;
+        result.Reserve(state_.size);
+        ForEachChunk([&result](const T* first, const T* last) {
+            result.Append(first, last);
+        });
+        return result;
+    }
+
+    // Изменяемый построитель версий. Узлы, созданные им, он меняет на месте, поэтому
+    // серия PushBack стоит амортизированно O(1) на элемент, а повторные Set в одном
+    // листе не копируют его. Persistent отдаёт результат и делает построитель пустым.
+    // Гарантии исключений строгие
+    class Transient {
+    public:
+        Transient() noexcept = default;
+
+        explicit Transient(const ImmutableVector& source) noexcept
+            : state_(Retain(source.state_))
+        {}
+
+        Transient(Transient&& other) noexcept
+            : state_(std::exchange(other.state_, State()))
+            , token_(std::exchange(other.token_, NewToken()))
+        {}
+
+        Transient& operator=(Transient&& rhs) noexcept {
+            if (this != &rhs) {
+                ReleaseState(state_);
+                state_ = std::exchange(rhs.state_, State());
+                token_ = std::exchange(rhs.token_, NewToken());
+            }
+            return *this;
+        }
+
+        ~Transient() {
+            ReleaseState(state_);
+        }
+
+        size_t Size() const noexcept {
+            return state_.size;
+        }
+
+        const T& operator[](size_t index) const noexcept {
+            assert(index < state_.size);
+            return ImmutableVector::LeafFor(state_, index)[index & MASK];
+        }
+
+        // Узлы, созданные до вызова, больше не меняются на месте: за них отвечает
+        // возвращённая версия
+        ImmutableVector Persistent() noexcept {
+            token_ = NewToken();
+            ImmutableVector result;
+            result.state_ = std::exchange(state_, State());
+            return result;
+        }
+
+        template <typename Value>
+        void Set(size_t index, Value&& value) {
+            assert(index < state_.size);
+
+            Node** slot = &state_.tail;
+            if (index < TailOffset(state_)) {
+                slot = &state_.root;
+                for (size_t shift = state_.shift; shift > 0; shift -= BITS) {
+                    slot = &MakeEditable(*slot, shift)->children[(index >> shift) & MASK];
+                }
+            }
+
+            Leaf* leaf = static_cast<Leaf*>(*slot);
+            if (leaf->owner == token_) {
+                leaf->Values()[index & MASK] = std::forward<Value>(value);
+                return;
+            }
+
+            // Старый лист освобождается после присваивания: value может ссылаться на него
+            Leaf* copy = CopyLeaf(leaf);
+            try {
+                copy->Values()[index & MASK] = std::forward<Value>(value);
+            } catch (...) {
+                Release(copy, 0);
+                throw;
+            }
+            *slot = copy;
+            Release(leaf, 0);
+        }
+
+        template <typename... Args>
+        T& EmplaceBack(Args&&... args) {
+            Leaf* tail = static_cast<Leaf*>(state_.tail);
+            if (tail != nullptr && tail->count == WIDTH) {
+                // Новый хвост создаётся раньше, чем старый уходит в дерево: args могут
+                // ссылаться на элементы вектора, а PushTail может бросить bad_alloc
+                Leaf* new_tail = NewLeaf();
+                try {
+                    Construct(new_tail, std::forward<Args>(args)...);
+                    PushTail(tail);
+                } catch (...) {
+                    Release(new_tail, 0);
+                    throw;
+                }
+                state_.tail = new_tail;
+
+            } else if (tail == nullptr || tail->owner != token_) {
+                Leaf* copy = tail != nullptr ? CopyLeaf(tail) : NewLeaf();
+                try {
+                    Construct(copy, std::forward<Args>(args)...);
+                } catch (...) {
+                    Release(copy, 0);
+                    throw;
+                }
+                state_.tail = copy;
+                Release(tail, 0);
+
+            } else {
+                Construct(tail, std::forward<Args>(args)...);
+            }
+
+            ++state_.size;
+            Leaf* result = static_cast<Leaf*>(state_.tail);
+            return result->Values()[result->count - 1];
+        }
+
+        template <typename Value>
+        void PushBack(Value&& value) {
+            EmplaceBack(std::forward<Value>(value));
+        }
+
+    private:
+        static uint64_t NewToken() noexcept {
+            static std::atomic<uint64_t> last_token = 0;
+            return last_token.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
+        Leaf* NewLeaf() {
+            return new Leaf(token_);
+        }
+
+        Leaf* CopyLeaf(Leaf* leaf) {
+            Leaf* copy = NewLeaf();
+            try {
+                std::uninitialized_copy_n(leaf->Values(), leaf->count, copy->Values());
+            } catch (...) {
+                delete copy;
+                throw;
+            }
+            copy->count = leaf->count;
+            return copy;
+        }
+
+        template <typename... Args>
+        static void Construct(Leaf* leaf, Args&&... args) {
+            new (leaf->Values() + leaf->count) T(std::forward<Args>(args)...);
+            ++leaf->count;
+        }
+
+        // Заменяет node копией, которую можно менять на месте. Копия делит детей с
+        // оригиналом, а ссылка на оригинал отпускается
+        Inner* MakeEditable(Node*& node, size_t shift) {
+            if (node != nullptr && node->owner == token_) {
+                return static_cast<Inner*>(node);
+            }
+
+            Inner* copy = new Inner(token_);
+            if (node != nullptr) {
+                const Inner* original = static_cast<const Inner*>(node);
+                for (size_t i = 0; i < WIDTH; ++i) {
+                    copy->children[i] = Retain(original->children[i]);
+                }
+                Release(node, shift);
+            }
+            node = copy;
+            return copy;
+        }
+
+        // Переносит полный хвост в дерево, при необходимости увеличивая его высоту
+        void PushTail(Leaf* tail) {
+            const size_t leaf_index = (state_.size - 1) >> BITS;
+            if (state_.root != nullptr && (leaf_index >> state_.shift) != 0) {
+                Inner* root = new Inner(token_);
+                root->children[0] = state_.root;
+                state_.root = root;
+                state_.shift += BITS;
+            }
+
+            // Сначала выделяются все узлы пути, и только потом в дерево попадает хвост
+            Node** slot = &state_.root;
+            for (size_t shift = state_.shift; shift > BITS; shift -= BITS) {
+                slot = &MakeEditable(*slot, shift)->children[(leaf_index >> (shift - BITS)) & MASK];
+            }
+            MakeEditable(*slot, BITS)->children[leaf_index & MASK] = tail;
+        }
+
+        State state_;
+        uint64_t token_ = NewToken();
+    };
+
+private:
+    static size_t TailOffset(const State& state) noexcept {
+        return state.size == 0 ? 0 : (state.size - 1) & ~MASK;
+    }
+
+    static const T* LeafFor(const State& state, size_t index) noexcept {
+        if (index >= TailOffset(state)) {
+            return static_cast<Leaf*>(state.tail)->Values();
+        }
+        const Node* node = state.root;
+        for (size_t shift = state.shift; shift > 0; shift -= BITS) {
+            node = static_cast<const Inner*>(node)->children[(index >> shift) & MASK];
+        }
+        return const_cast<Leaf*>(static_cast<const Leaf*>(node))->Values();
+    }
+
+    const T* LeafFor(size_t index) const noexcept {
+        return LeafFor(state_, index);
+    }
+
+    template <typename N>
+    static N* Retain(N* node) noexcept {
+        if (node != nullptr) {
+            node->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        return node;
+    }
+
+    static State Retain(const State& state) noexcept {
+        Retain(state.root);
+        Retain(state.tail);
+        return state;
+    }
+
+    // shift равен 0 для листа. Последний владелец узла видит все записи в него благодаря acq_rel
+    static void Release(Node* node, size_t shift) noexcept {
+        if (node == nullptr || node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        if (shift == 0) {
+            delete static_cast<Leaf*>(node);
+            return;
+        }
+        Inner* inner = static_cast<Inner*>(node);
+        for (Node* child : inner->children) {
+            Release(child, shift - BITS);
+        }
+        delete inner;
+    }
+
+    static void ReleaseState(State& state) noexcept {
+        Release(state.root, state.shift);
+        Release(state.tail, 0);
+        state = State();
+    }
+
+    State state_;
+};
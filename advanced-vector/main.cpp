@@ -1,8 +1,31 @@
 #include "vector.h"
+#include "aligned_allocator.h"
+#include "arena.h"
+#include "chunked_vector.h"
+#include "concurrent_vector.h"
+#include "cow_vector.h"
+#include "immutable_vector.h"
+#include "mapped_vector.h"
+#include "numa.h"
+#include "pool_allocator.h"
+#include "simd.h"
+#include "slot_map.h"
+#include "small_vector.h"
+#include "soa_vector.h"
+#include "static_vector.h"
+#include "vector_io.h"
+#include "vector_stats.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <iostream>
+#include <list>
+#include <numeric>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -116,8 +139,154 @@ struct Obj {
     static inline int num_move_assigned = 0;
 };
 
+// Аллокатор с состоянием: считает выделенные байты и сравнивается по идентификатору
+template <typename T, bool Propagate>
+struct TrackingAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_move_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_swap = std::bool_constant<Propagate>;
+    using is_always_equal = std::false_type;
+
+    template <typename U>
+    struct rebind {
+        using other = TrackingAllocator<U, Propagate>;
+    };
+
+    explicit TrackingAllocator(int id = 0) noexcept
+        : id(id)  //
+    {}
+
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U, Propagate>& other) noexcept
+        : id(other.id)  //
+    {}
+
+    T* allocate(size_t n) {
+        live_bytes += n * sizeof(T);
+        return static_cast<T*>(operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        live_bytes -= n * sizeof(T);
+        operator delete(p);
+    }
+
+    bool operator==(const TrackingAllocator& other) const noexcept {
+        return id == other.id;
+    }
+
+    bool operator!=(const TrackingAllocator& other) const noexcept {
+        return id != other.id;
+    }
+
+    int id = 0;
+
+    static inline size_t live_bytes = 0;
+};
+
+// Тип с нетривиальными конструкторами, который разрешено перемещать побайтно
+struct RelocatableObj {
+    explicit RelocatableObj(int id)
+        : id(std::make_unique<int>(id))  //
+    {}
+
+    RelocatableObj(RelocatableObj&& other) noexcept
+        : id(std::move(other.id))  //
+    {
+        ++num_moved;
+    }
+
+    RelocatableObj& operator=(RelocatableObj&& other) = default;
+
+    ~RelocatableObj() {
+        ++num_destroyed;
+    }
+
+    std::unique_ptr<int> id;
+
+    static inline int num_moved = 0;
+    static inline int num_destroyed = 0;
+};
+
+// Счётчики атомарные, потому что элементы конструируются из нескольких потоков
+struct ConcurrentObj {
+    ConcurrentObj() {
+        if (++num_constructed == throw_after) {
+            throw std::runtime_error("Oops");
+        }
+        ++alive;
+    }
+
+    ConcurrentObj(const ConcurrentObj& other)
+        : value(other.value)
+    {
+        if (++num_constructed == throw_after) {
+            throw std::runtime_error("Oops");
+        }
+        ++alive;
+    }
+
+    ConcurrentObj& operator=(const ConcurrentObj&) = default;
+
+    ~ConcurrentObj() {
+        --alive;
+    }
+
+    static void ResetCounters(int throw_after_count = 0) {
+        num_constructed = 0;
+        alive = 0;
+        throw_after = throw_after_count;
+    }
+
+    int value = 7;
+
+    inline static std::atomic<int> num_constructed = 0;
+    inline static std::atomic<int> alive = 0;
+    inline static int throw_after = 0;
+};
+
+// Перемещение может бросить исключение, поэтому вставка в середину даёт лишь базовую гарантию
+struct ThrowingMoveObj {
+    explicit ThrowingMoveObj(int value)
+        : value(value)
+    {
+        ++alive;
+    }
+
+    ThrowingMoveObj(const ThrowingMoveObj& other)
+        : value(other.value)
+    {
+        ++alive;
+    }
+
+    ThrowingMoveObj& operator=(ThrowingMoveObj&& rhs) {
+        if (--assignments_before_throw == 0) {
+            throw std::runtime_error("Oops");
+        }
+        value = rhs.value;
+        return *this;
+    }
+
+    ~ThrowingMoveObj() {
+        --alive;
+    }
+
+    int value = 0;
+
+    inline static int alive = 0;
+    inline static int assignments_before_throw = 0;
+};
+
+struct RegistryTag {
+    static constexpr const char* NAME = "registry-test";
+};
+
 }  // namespace
 
+template <>
+struct IsTriviallyRelocatable<RelocatableObj> : std::true_type {};
+
 void Test1() {
     Obj::ResetCounters();
     const size_t SIZE = 100500;
@@ -558,85 +727,1699 @@ void Test6() {
     }
 }
 
-struct C {
-    C() noexcept {
-        ++def_ctor;
+void Test7() {
+    const size_t SIZE = 10;
+    const int ID = 42;
+    using PropagatingAlloc = TrackingAllocator<Obj, true>;
+    using StickyAlloc = TrackingAllocator<Obj, false>;
+    {
+        Obj::ResetCounters();
+        Vector<Obj, StickyAlloc> v(SIZE, StickyAlloc{1});
+        assert(StickyAlloc::live_bytes == SIZE * sizeof(Obj));
+        v.PushBack(Obj{ID});
+        assert(StickyAlloc::live_bytes == SIZE * 2 * sizeof(Obj));
+        assert(v.GetAllocator().id == 1);
+
+        Vector<Obj, StickyAlloc> v_copy(v);
+        assert(v_copy.GetAllocator().id == 1);
+        assert(v_copy[SIZE].id == ID);
+    }
+    assert(StickyAlloc::live_bytes == 0);
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        Vector<Obj, StickyAlloc> v(SIZE, StickyAlloc{1});
+        Vector<Obj, StickyAlloc> other(SIZE / 2, StickyAlloc{2});
+        other[0].id = ID;
+        // Аллокаторы не равны и не распространяются: элементы перемещаются поштучно
+        v = std::move(other);
+        assert(v.GetAllocator().id == 1);
+        assert(v.Size() == SIZE / 2);
+        assert(v.Capacity() == SIZE);
+        assert(v[0].id == ID);
+        assert(Obj::num_move_assigned == SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == SIZE / 2 + SIZE / 2);
     }
-    C(const C& /*other*/) noexcept {
-        ++copy_ctor;
+    assert(StickyAlloc::live_bytes == 0);
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        Vector<Obj, StickyAlloc> v(SIZE, StickyAlloc{1});
+        Vector<Obj, StickyAlloc> other(SIZE / 2, StickyAlloc{1});
+        // Равные аллокаторы: буфер забирается целиком, старые элементы уничтожаются
+        v = std::move(other);
+        assert(v.Size() == SIZE / 2);
+        assert(Obj::num_moved == 0);
+        assert(Obj::GetAliveObjectCount() == SIZE / 2);
+        assert(StickyAlloc::live_bytes == SIZE / 2 * sizeof(Obj));
     }
-    C(C&& /*other*/) noexcept {
-        ++move_ctor;
+    assert(StickyAlloc::live_bytes == 0);
+    {
+        Obj::ResetCounters();
+        Vector<Obj, PropagatingAlloc> v(SIZE, PropagatingAlloc{1});
+        Vector<Obj, PropagatingAlloc> other(SIZE / 2, PropagatingAlloc{2});
+        v = other;
+        assert(v.GetAllocator().id == 2);
+        assert(v.Size() == SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == SIZE / 2 + SIZE / 2);
+
+        Vector<Obj, PropagatingAlloc> third(SIZE, PropagatingAlloc{3});
+        v = std::move(third);
+        assert(v.GetAllocator().id == 3);
+        assert(v.Size() == SIZE);
+        assert(Obj::num_moved == 0);
+
+        v.Swap(other);
+        assert(v.GetAllocator().id == 2);
+        assert(other.GetAllocator().id == 3);
+        assert(other.Size() == SIZE);
     }
-    C& operator=(const C& other) noexcept {
-        if (this != &other) {
-            ++copy_assign;
+    assert(PropagatingAlloc::live_bytes == 0);
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test8() {
+    const size_t SIZE = 128;
+    static_assert(IsTriviallyRelocatable<int>::value);
+    static_assert(IsTriviallyRelocatable<std::unique_ptr<int>>::value);
+    static_assert(!IsTriviallyRelocatable<Obj>::value);
+    {
+        Vector<RelocatableObj> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
         }
-        return *this;
+        assert(v.Size() == v.Capacity());
+        v.Emplace(v.cbegin() + SIZE / 2, -1);
+        v.Reserve(SIZE * 4);
+        assert(v.Size() == SIZE + 1);
+        assert(*v[SIZE / 2].id == -1);
+        assert(*v[SIZE / 2 + 1].id == static_cast<int>(SIZE / 2));
+        assert(*v[SIZE].id == static_cast<int>(SIZE - 1));
+        // Перенос при реаллокации выполняется memcpy, без перемещений и деструкторов
+        assert(RelocatableObj::num_moved == 0);
+        assert(RelocatableObj::num_destroyed == 0);
     }
-    C& operator=(C&& /*other*/) noexcept {
-        ++move_assign;
-        return *this;
+    assert(RelocatableObj::num_destroyed == static_cast<int>(SIZE + 1));
+    {
+        Vector<std::unique_ptr<int>> v;
+        for (int i = 0; i < static_cast<int>(SIZE); ++i) {
+            v.PushBack(std::make_unique<int>(i));
+        }
+        v.Insert(v.cbegin(), std::make_unique<int>(-1));
+        assert(*v[0] == -1);
+        assert(*v[SIZE] == static_cast<int>(SIZE - 1));
+    }
+}
+
+void Test9() {
+    const int SIZE = 100'000;
+    static_assert(HasReallocate<MallocAllocator<int>>::value);
+    static_assert(!HasReallocate<std::allocator<int>>::value);
+    {
+        Vector<int, MallocAllocator<int>> v;
+        for (int i = 0; i < SIZE; ++i) {
+            v.PushBack(i);
+        }
+        v.Insert(v.cbegin(), -1);
+        v.Reserve(SIZE * 4);
+        assert(v.Size() == SIZE + 1);
+        assert(v.Capacity() == SIZE * 4);
+        assert(v[0] == -1);
+        for (int i = 0; i < SIZE; ++i) {
+            assert(v[i + 1] == i);
+        }
     }
-    ~C() {
-        ++dtor;
+    {
+        Vector<std::unique_ptr<int>, MallocAllocator<std::unique_ptr<int>>> v;
+        v.PushBack(std::make_unique<int>(1));
+        // Ссылка на элемент самого вектора должна пережить перенос буфера
+        v.EmplaceBack(std::move(v[0]));
+        v.Emplace(v.cbegin(), std::make_unique<int>(0));
+        assert(v.Size() == 3);
+        assert(*v[0] == 0);
+        assert(v[1] == nullptr);
+        assert(*v[2] == 1);
     }
+}
 
-    static void Reset() {
-        def_ctor = 0;
-        copy_ctor = 0;
-        move_ctor = 0;
-        copy_assign = 0;
-        move_assign = 0;
-        dtor = 0;
+void Test10() {
+    const auto capacities = [](auto& v, size_t count) {
+        std::vector<size_t> result;
+        for (size_t i = 0; i < count; ++i) {
+            v.EmplaceBack();
+            if (result.empty() || result.back() != v.Capacity()) {
+                result.push_back(v.Capacity());
+            }
+        }
+        return result;
+    };
+    {
+        Vector<int, std::allocator<int>, OneAndHalfGrowth> v;
+        assert((capacities(v, 20) == std::vector<size_t>{1, 2, 3, 4, 6, 9, 13, 19, 28}));
+    }
+    {
+        Vector<int, std::allocator<int>, MinCapacityGrowth<>> v;
+        assert((capacities(v, 40) == std::vector<size_t>{16, 32, 64}));
+    }
+    {
+        Vector<std::array<char, 24>, std::allocator<std::array<char, 24>>, SizeClassGrowth<>> v;
+        assert((capacities(v, 200) == std::vector<size_t>{1, 2, 5, 10, 21, 42, 85, 170, 341}));
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj, std::allocator<Obj>, OneAndHalfGrowth> v(4);
+        v.Emplace(v.cbegin() + 1, 1);
+        assert(v.Capacity() == 6);
+        assert(v[1].id == 1);
+        assert(Obj::num_moved == 4);
     }
+}
 
-    inline static size_t def_ctor = 0;
-    inline static size_t copy_ctor = 0;
-    inline static size_t move_ctor = 0;
-    inline static size_t copy_assign = 0;
-    inline static size_t move_assign = 0;
-    inline static size_t dtor = 0;
-};
+void Test11() {
+    const size_t N = 4;
+    const int ID = 42;
+    using SmallObjVector = SmallVector<Obj, N>;
+    {
+        Obj::ResetCounters();
+        SmallObjVector v;
+        assert(v.IsInline());
+        assert(v.Capacity() == N);
+        for (size_t i = 0; i < N; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        assert(v.IsInline());
+        // Пятый элемент переводит вектор в кучу
+        v.EmplaceBack(ID);
+        assert(!v.IsInline());
+        assert(v.Capacity() == N * 2);
+        assert(v[N].id == ID);
+        assert(Obj::num_moved == N);
+        assert(Obj::GetAliveObjectCount() == N + 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        SmallObjVector v(N);
+        try {
+            v[N / 2].throw_on_copy = true;
+            SmallObjVector v_copy(v);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+            assert(Obj::num_copied == N / 2);
+        }
+        assert(Obj::GetAliveObjectCount() == N);
+    }
+    {
+        Obj::ResetCounters();
+        SmallObjVector v(N);
+        v.Insert(v.cbegin() + 1, Obj{ID});
+        assert(v.Size() == N + 1);
+        assert(v[1].id == ID);
+        assert(Obj::num_copied == 0);
+        assert(Obj::GetAliveObjectCount() == N + 1);
+        v.Erase(v.cbegin());
+        assert(v[0].id == ID);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        SmallVector<TestObj, 1> v(1);
+        v.PushBack(v[0]);
+        v.Insert(v.cbegin(), v[1]);
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
+            return obj.IsAlive();
+        }));
+    }
+    {
+        Obj::ResetCounters();
+        SmallObjVector small(N / 2);
+        small[0].id = 1;
+        SmallObjVector large(N * 2);
+        large[0].id = 2;
+
+        small.Swap(large);
+        assert(small.Size() == N * 2 && !small.IsInline() && small[0].id == 2);
+        assert(large.Size() == N / 2 && large.IsInline() && large[0].id == 1);
 
-void Dump() {
-    using namespace std;
-    cerr << "Def ctors: "sv << C::def_ctor              //
-         << ", Copy ctors: "sv << C::copy_ctor          //
-         << ", Move ctors: "sv << C::move_ctor          //
-         << ", Copy assignments: "sv << C::copy_assign  //
-         << ", Move assignments: "sv << C::move_assign  //
-         << ", Dtors: "sv << C::dtor << endl;
+        SmallObjVector moved(std::move(small));
+        assert(moved.Size() == N * 2 && moved[0].id == 2);
+        assert(small.Size() == 0 && small.IsInline());
+
+        moved = large;
+        assert(moved.Size() == N / 2 && moved[0].id == 1);
+        assert(moved.Capacity() == N * 2);
+
+        large = std::move(moved);
+        assert(large.Size() == N / 2 && !large.IsInline());
+        assert(Obj::GetAliveObjectCount() == N / 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
 }
 
-void Benchmark() {
-    using namespace std;
-    try {
-        const size_t NUM = 10;
-        C c;
-        {
-            cerr << "std::vector:"sv << endl;
-            C::Reset();
-            vector<C> v(NUM);
-            Dump();
-            v.push_back(c);
+void Test12() {
+    const size_t SIZE = 10;
+    const int ID = 42;
+    {
+        const std::vector<int> source{1, 2, 3, 4, 5};
+        Vector<int> v(source.begin(), source.end());
+        assert(v.Size() == source.size());
+        assert(v.Capacity() == source.size());
+        assert(std::equal(v.begin(), v.end(), source.begin()));
+
+        v.Insert(v.cbegin() + 2, {10, 11, 12});
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{1, 2, 10, 11, 12, 3, 4, 5}));
+
+        std::istringstream input("7 8 9");
+        v.Insert(v.cbegin() + 1, std::istream_iterator<int>(input), std::istream_iterator<int>());
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{1, 7, 8, 9, 2, 10, 11, 12, 3, 4, 5}));
+
+        v.Assign({6, 5});
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{6, 5}));
+    }
+    {
+        // Исключение из однопроходного итератора не оставляет живых элементов
+        Obj::ResetCounters();
+        std::istringstream input("1 2 3 x");
+        input.exceptions(std::ios::failbit);
+        try {
+            Vector<Obj> v{std::istream_iterator<int>(input), std::istream_iterator<int>()};
+            assert(false);
+        } catch (const std::ios::failure&) {
         }
-        Dump();
-    } catch (...) {
+        assert(Obj::num_constructed_with_id == 3 && Obj::GetAliveObjectCount() == 0);
     }
-    try {
-        const size_t NUM = 10;
-        C c;
+    {
+        Vector<std::string> v{"a", "b", "c", "d"};
+        const std::list<std::string> source{"x", "y", "z"};
+        v.Reserve(v.Size() + source.size());
+        v.Insert(v.cbegin() + 3, source.begin(), source.end());
+        assert((std::vector<std::string>(v.begin(), v.end())
+                == std::vector<std::string>{"a", "b", "c", "x", "y", "z", "d"}));
+        v.Insert(v.cbegin() + 1, source.begin(), source.end());
+        assert((std::vector<std::string>(v.begin(), v.end())
+                == std::vector<std::string>{"a", "x", "y", "z", "b", "c", "x", "y", "z", "d"}));
+        v.Append(source.begin(), source.end());
+        assert(v.Size() == 13 && v[12] == "z");
+        v.Assign(source.begin(), source.end());
+        assert((std::vector<std::string>(v.begin(), v.end()) == std::vector<std::string>{"x", "y", "z"}));
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Reserve(SIZE * 2);
+        const std::vector<Obj> batch(3, Obj{ID});
+        const int batch_size = static_cast<int>(batch.size());
+        Obj::ResetCounters();
+        v.Insert(v.cbegin() + 1, batch.begin(), batch.end());
+        assert(v.Size() == SIZE + batch.size());
+        assert(v[1].id == ID && v[3].id == ID && v[4].id == 0);
+        // Хвост из SIZE - 1 элементов сдвигается один раз, а не на каждый вставленный элемент
+        assert(Obj::num_moved + Obj::num_move_assigned == SIZE - 1);
+        assert(Obj::num_copied + Obj::num_assigned == batch_size);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        std::vector<Obj> batch(3);
+        batch[1].throw_on_copy = true;
+        try {
+            v.Insert(v.cbegin() + 1, batch.begin(), batch.end());
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        // При реаллокации действует строгая гарантия
+        assert(v.Size() == SIZE);
+        assert(v.Capacity() == SIZE);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE + batch.size()));
+    }
+}
+
+void Test13() {
+    const size_t SIZE = 10;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i].id = static_cast<int>(i);
+        }
+        auto* pos = v.Erase(v.cbegin() + 2, v.cbegin() + 5);
+        assert(pos == v.begin() + 2);
+        assert(v.Size() == SIZE - 3);
+        assert(v[2].id == 5);
+        assert(Obj::num_move_assigned == SIZE - 5);
+        assert(Obj::GetAliveObjectCount() == SIZE - 3);
+
+        assert(EraseIf(v, [](const Obj& obj) {
+                   return obj.id % 2 == 1;
+               }) == 4);
+        assert(v.Size() == 3);
+        assert(v[0].id == 0 && v[1].id == 6 && v[2].id == 8);
+        assert(Obj::GetAliveObjectCount() == 3);
+    }
+    {
+        Vector<int> v{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        v.Erase(v.cbegin() + 7, v.cend());
+        v.Erase(v.cbegin(), v.cbegin() + 1);
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{1, 2, 3, 4, 5, 6}));
+        assert(EraseIf(v, [](int x) {
+                   return x == 2 || x == 3 || x == 6;
+               }) == 3);
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{1, 4, 5}));
+    }
+    {
+        Vector<RelocatableObj> v;
+        for (int i = 0; i < static_cast<int>(SIZE); ++i) {
+            v.EmplaceBack(i);
+        }
+        RelocatableObj::num_destroyed = 0;
+        int calls = 0;
+        try {
+            EraseIf(v, [&calls](const RelocatableObj& obj) {
+                if (++calls == 8) {
+                    throw std::runtime_error("Oops");
+                }
+                return *obj.id % 3 == 0;
+            });
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        // Удалены 0, 3 и 6, остальные элементы сохранены по порядку без перемещений
+        assert(RelocatableObj::num_destroyed == 3);
+        assert(RelocatableObj::num_moved == 0);
+        assert(v.Size() == SIZE - 3);
+        const std::vector<int> expected{1, 2, 4, 5, 7, 8, 9};
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(*v[i].id == expected[i]);
+        }
+    }
+}
+
+void Test14() {
+    const size_t SIZE = 1000;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE, default_init);
+        v.ResizeDefaultInit(SIZE * 2);
+        // Для классов с конструктором инициализация по умолчанию вызывает его
+        assert(Obj::num_default_constructed == SIZE * 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Vector<uint8_t> v(SIZE, default_init);
+        std::fill(v.begin(), v.end(), 7);
+        v.ResizeDefaultInit(SIZE / 2);
+        assert(v.Size() == SIZE / 2);
+        assert(v.Capacity() == SIZE);
+        assert(v[SIZE / 2 - 1] == 7);
+    }
+#ifdef __cpp_lib_span
+    {
+        Vector<float> v;
+        v.PushBack(1.0f);
+        std::span<float> tail = v.AppendUninitialized(SIZE);
+        assert(tail.size() == SIZE);
+        assert(tail.data() == &v[1]);
+        std::fill(tail.begin(), tail.end(), 2.0f);
+        assert(v.Size() == SIZE + 1);
+        assert(v[0] == 1.0f && v[SIZE] == 2.0f);
+
+        const size_t capacity = v.Capacity();
+        v.AppendUninitialized(capacity - v.Size());
+        assert(v.Capacity() == capacity);
+    }
+#endif
+}
+
+void Test15() {
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Resize(SIZE / 2);
+        assert(v.Capacity() == SIZE);
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE / 2);
+        assert(Obj::num_moved == SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == SIZE / 2);
+
+        v.Clear();
+        assert(v.Size() == 0);
+        assert(v.Capacity() == SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == 0);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0);
+    }
+    {
+        Vector<int, std::allocator<int>, ShrinkingGrowth<>> v(SIZE);
+        v.Resize(SIZE / 4);
+        assert(v.Capacity() == SIZE);
+        v.PopBack();
+        // 24 элемента меньше четверти ёмкости: буфер уменьшается до удвоенного размера
+        assert(v.Size() == SIZE / 4 - 1);
+        assert(v.Capacity() == (SIZE / 4 - 1) * 2);
+        v.Erase(v.cbegin(), v.cbegin() + 20);
+        assert(v.Capacity() == 8);
+        v.Clear();
+        assert(v.Capacity() == 0);
+        v.PushBack(1);
+        assert(v.Capacity() == 1);
+    }
+}
+
+void Test16() {
+    // Пустая политика не увеличивает размер вектора
+    static_assert(sizeof(Vector<int>) == 3 * sizeof(void*));
+    {
+        Vector<std::string, std::allocator<std::string>, DoublingGrowth, VectorStats> v;
+        for (int i = 0; i < 5; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        // Ёмкость 1 -> 2 -> 4 -> 8, перенесено 1 + 2 + 4 элемента
+        VectorStatsSnapshot stats = v.GetStats().Snapshot();
+        assert(stats.reallocations == 4);
+        assert(stats.elements_moved == 7);
+        assert(stats.elements_copied == 0);
+        assert(stats.peak_capacity == 8);
+        assert(stats.bytes_allocated == 15 * sizeof(std::string));
+        assert(stats.bytes_freed == 7 * sizeof(std::string));
+
+        v.Insert(v.cbegin() + 1, "x");
+        v.Erase(v.cbegin());
+        stats = v.GetStats().Snapshot();
+        assert(stats.inserts == 1 && stats.insert_shift == 4);
+        assert(stats.erases == 1 && stats.erase_shift == 5);
+
+        auto moved = std::move(v);
+        assert(moved.GetStats().Snapshot().reallocations == 4);
+        assert(v.GetStats().Snapshot().reallocations == 0);
+
+        // Присваивание перемещением и обмен переносят счётчики вместе с буфером
+        Vector<std::string, std::allocator<std::string>, DoublingGrowth, VectorStats> target(3);
+        target = std::move(moved);
+        assert(target.GetStats().Snapshot().reallocations == 4);
+        assert(moved.GetStats().Snapshot().bytes_allocated == 0);
+        Vector<std::string, std::allocator<std::string>, DoublingGrowth, VectorStats> other(2);
+        target.Swap(other);
+        assert(other.GetStats().Snapshot().reallocations == 4);
+        target.Clear();
+        target.ShrinkToFit();
+        stats = target.GetStats().Snapshot();
+        assert(stats.bytes_allocated == 2 * sizeof(std::string) && stats.bytes_freed == stats.bytes_allocated);
+    }
+    {
+        struct Tag {};
+        using Stats = SharedVectorStats<Tag>;
+        Stats::Reset();
         {
-            cerr << "Vector:"sv << endl;
-            C::Reset();
-            Vector<C> v(NUM);
-            Dump();
-            v.PushBack(c);
+            Vector<int, std::allocator<int>, DoublingGrowth, Stats> a(10);
+            Vector<int, std::allocator<int>, DoublingGrowth, Stats> b;
+            b = a;
+            b.Reserve(20);
+        }
+        VectorStatsSnapshot stats = Stats::Snapshot();
+        assert(stats.reallocations == 2);
+        assert(stats.elements_relocated == 10);
+        assert(stats.peak_capacity == 20);
+        assert(stats.bytes_allocated == (10 + 10 + 20) * sizeof(int));
+        assert(stats.bytes_freed == stats.bytes_allocated);
+    }
+}
+
+void Test17() {
+    {
+        ArenaScope scope;
+        Vector<int, ArenaAllocator<int>> v;
+        assert(v.GetAllocator().GetArena() == &scope.GetArena());
+        v.Reserve(4);
+        const int* data = v.begin();
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(i);
         }
-        Dump();
-    } catch (...) {
+        // Буфер последний в арене, поэтому растёт на месте
+        assert(v.begin() == data);
+        assert(v[999] == 999);
+
+        Vector<int, ArenaAllocator<int>> other(10);
+        v.Reserve(v.Capacity() + 1);
+        assert(v.begin() != data);
+        assert(v[0] == 0 && v[999] == 999);
+    }
+    {
+        Obj::ResetCounters();
+        ArenaScope outer;
+        Vector<Obj, ArenaAllocator<Obj>> v(5);
+        {
+            ArenaScope inner;
+            // Вектор продолжает брать память из арены, активной при его создании
+            v.Resize(100);
+            assert(v.GetAllocator().GetArena() == &outer.GetArena());
+
+            Vector<Obj, ArenaAllocator<Obj>> copy(v);
+            assert(copy.GetAllocator().GetArena() == &inner.GetArena());
+            assert(copy.Size() == 100);
+        }
+        assert(Obj::GetAliveObjectCount() == 100);
+        v.Clear();
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Вне ArenaScope аллокатор обращается к operator new
+        Vector<std::string, ArenaAllocator<std::string>> v;
+        assert(v.GetAllocator().GetArena() == nullptr);
+        v.PushBack(std::string(100, 'x'));
+        v.Reserve(16);
+        assert(v[0] == std::string(100, 'x'));
+    }
+}
+
+void Test18() {
+    {
+        // Буфер, освобождённый при росте одного вектора, сразу достаётся другому
+        Vector<int, PoolAllocator<int>> a(32);
+        const int* freed = a.begin();
+        a.Reserve(64);
+        Vector<int, PoolAllocator<int>> b(30);
+        assert(b.begin() == freed);
+    }
+    {
+        using Elem = std::array<char, 24>;
+        Vector<Elem, PoolAllocator<Elem>, PoolGrowth<>> v;
+        v.EmplaceBack();
+        assert(v.Capacity() == 1);
+        v.EmplaceBack();
+        // 2 * 24 байта округляются до класса 64
+        assert(v.Capacity() == 2);
+        v.EmplaceBack();
+        assert(v.Capacity() == 5);
+        v.Reserve(Pool::MAX_BLOCK_SIZE);
+        assert(v.Capacity() == Pool::MAX_BLOCK_SIZE);
+    }
+    {
+        // Кэши завершившихся потоков сдают блоки в общее хранилище
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([] {
+                for (int round = 0; round < 100; ++round) {
+                    Vector<Vector<int, PoolAllocator<int>>> vectors;
+                    for (int i = 0; i < 50; ++i) {
+                        vectors.EmplaceBack(static_cast<size_t>(i));
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        Pool::Trim();
+    }
+}
+
+void Test19() {
+    const auto is_aligned = [](const void* p, size_t alignment) {
+        return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+    };
+    {
+        Vector<float, AlignedAllocator<float>> v;
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(static_cast<float>(i));
+            assert(is_aligned(v.begin(), 64));
+        }
+        Vector<double, AlignedAllocator<double, 4096>> page(3);
+        assert(is_aligned(page.begin(), 4096));
+    }
+    {
+        // Порог занижен, чтобы тест отображал и переотображал буферы в несколько мегабайт
+        Vector<int, HugePageAllocator<int, 64, 1 << 16>> v;
+        for (int i = 0; i < (1 << 20); ++i) {
+            v.PushBack(i);
+            assert(v[i / 2] == i / 2);
+        }
+        assert(is_aligned(v.begin(), 64));
+        v.Resize(10);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 10 && v[9] == 9);
+
+        Vector<std::string, HugePageAllocator<std::string>> strings(100000);
+        strings[99999] = "last";
+        strings.Reserve(200000);
+        assert(strings[99999] == "last");
+    }
+}
+
+void Test20() {
+    struct Record {
+        int id;
+        double value;
+    };
+
+    const std::string path = "/tmp/mapped_vector_test_" + std::to_string(getpid());
+    unlink(path.c_str());
+    {
+        MappedVector<Record> v(path);
+        assert(v.Size() == 0);
+        for (int i = 0; i < 10000; ++i) {
+            v.PushBack({i, i * 0.5});
+        }
+        v.EmplaceBack(v[0]);
+        v.Flush();
+    }
+    {
+        // Повторное открытие ничего не читает: элементы уже в отображении
+        MappedVector<Record> v(path);
+        assert(v.Size() == 10001);
+        assert(v[9999].id == 9999 && v[9999].value == 9999 * 0.5);
+        assert(v[10000].id == 0);
+        v.PopBack();
+        v.Reserve(50000);
+        assert(v[5000].id == 5000);
+    }
+    {
+        MappedVector<Record> v(path);
+        assert(v.Size() == 10000);
+        assert(v.Capacity() >= 50000);
+        int sum = 0;
+        for (const Record& record : v) {
+            sum += record.id % 2;
+        }
+        assert(sum == 5000);
+
+        // Перемещённый вектор пуст, как и Vector
+        MappedVector<Record> moved(std::move(v));
+        assert(moved.Size() == 10000);
+        assert(v.Size() == 0 && v.Capacity() == 0 && v.begin() == v.end());
+        for ([[maybe_unused]] const Record& record : v) {
+            assert(false);
+        }
+        v.Clear();
+        v.Flush();
+        v = std::move(moved);
+        assert(v.Size() == 10000 && v[9999].id == 9999 && moved.Size() == 0);
+    }
+    try {
+        MappedVector<int> wrong_type(path);
+        assert(false);
+    } catch (const std::runtime_error&) {
+    }
+    unlink(path.c_str());
+}
+
+void Test21() {
+    struct Point {
+        float x;
+        float y;
+    };
+
+    Vector<Point> points;
+    for (int i = 0; i < 1000; ++i) {
+        points.PushBack(Point{static_cast<float>(i), -static_cast<float>(i)});
+    }
+    Vector<std::uint64_t> ids{1, 2, 3};
+    Vector<char> empty;
+    {
+        FILE* file = std::tmpfile();
+        const int fd = fileno(file);
+        WriteTo(fd, points, ids, empty);
+        lseek(fd, 0, SEEK_SET);
+
+        Vector<Point> read_points;
+        Vector<std::uint64_t> read_ids(100);
+        Vector<char> read_empty(5);
+        ReadFrom(fd, read_points, read_ids, read_empty);
+        assert(read_points.Size() == 1000 && read_points.Capacity() == 1000);
+        assert(read_points[999].x == 999.0f && read_points[999].y == -999.0f);
+        assert(read_ids.Size() == 3 && read_ids[2] == 3);
+        assert(read_empty.Size() == 0);
+
+        // Второе чтение натыкается на конец файла
+        try {
+            ReadFrom(fd, read_ids);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+
+        // Заголовок, обещающий больше элементов, чем есть в файле, отвергается до выделения памяти
+        VectorIoHeader corrupt = MakeVectorIoHeader(ids);
+        corrupt.count = std::uint64_t{1} << 40;
+        lseek(fd, 0, SEEK_SET);
+        assert(write(fd, &corrupt, sizeof(corrupt)) == sizeof(corrupt));
+        lseek(fd, 0, SEEK_SET);
+        try {
+            ReadFrom(fd, read_ids);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(read_ids.Size() == 0 && read_ids.Capacity() == 100);
+        std::fclose(file);
+    }
+    {
+        // Из канала длину не узнать, поэтому вектор растёт по мере чтения
+        int pipe_fds[2];
+        assert(pipe(pipe_fds) == 0);
+        WriteTo(pipe_fds[1], ids);
+        VectorIoHeader corrupt = MakeVectorIoHeader(ids);
+        corrupt.count = std::uint64_t{1} << 40;
+        assert(write(pipe_fds[1], &corrupt, sizeof(corrupt)) == sizeof(corrupt));
+        assert(write(pipe_fds[1], ids.begin(), sizeof(std::uint64_t)) == sizeof(std::uint64_t));
+        close(pipe_fds[1]);
+
+        Vector<std::uint64_t> read_ids;
+        ReadFrom(pipe_fds[0], read_ids);
+        assert(read_ids.Size() == 3 && read_ids[2] == 3);
+        try {
+            ReadFrom(pipe_fds[0], read_ids);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(read_ids.Size() == 0 && read_ids.Capacity() <= VECTOR_IO_CHUNK_BYTES / sizeof(std::uint64_t));
+        close(pipe_fds[0]);
+    }
+    {
+        std::stringstream stream;
+        WriteTo(stream, ids);
+        WriteTo(stream, points);
+
+        Vector<std::uint64_t> read_ids;
+        ReadFrom(stream, read_ids);
+        assert(read_ids.Size() == 3 && read_ids[0] == 1);
+
+        Vector<std::uint32_t> wrong_size;
+        try {
+            ReadFrom(stream, wrong_size);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+
+        std::stringstream corrupt_stream;
+        VectorIoHeader corrupt = MakeVectorIoHeader(ids);
+        corrupt.count = std::uint64_t{1} << 40;
+        corrupt_stream.write(reinterpret_cast<const char*>(&corrupt), sizeof(corrupt));
+        try {
+            ReadFrom(corrupt_stream, read_ids);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(read_ids.Size() == 0);
+
+#ifdef __cpp_lib_span
+        const std::string bytes = stream.str();
+        std::vector<std::uint64_t> aligned(bytes.size() / sizeof(std::uint64_t) + 1);
+        std::memcpy(aligned.data(), bytes.data(), bytes.size());
+        std::span<const std::byte> buffer(reinterpret_cast<const std::byte*>(aligned.data()), bytes.size());
+
+        std::span<const std::byte> rest;
+        std::span<const std::uint64_t> id_view = ViewVector<std::uint64_t>(buffer, &rest);
+        assert(id_view.size() == 3 && id_view[1] == 2);
+        std::span<const Point> point_view = ViewVector<Point>(rest, &rest);
+        assert(point_view.size() == 1000 && point_view[10].x == 10.0f);
+        assert(rest.empty());
+
+        try {
+            ViewVector<std::uint64_t>(buffer.first(sizeof(VectorIoHeader) + 2 * sizeof(std::uint64_t)));
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+#endif
+    }
+}
+
+void Test22() {
+    {
+        std::allocator<std::string> alloc;
+        std::string* buffer = alloc.allocate(4);
+        new (buffer) std::string("a");
+        new (buffer + 1) std::string("b");
+
+        Vector<std::string> v(3);
+        v.Adopt(buffer, 2, 4);
+        assert(v.Size() == 2 && v.Capacity() == 4);
+        assert(v.begin() == buffer && v[1] == "b");
+        v.PushBack("c");
+        assert(v.begin() == buffer);
+
+        VectorBuffer<std::string> released = v.Release();
+        assert(v.Size() == 0 && v.Capacity() == 0);
+        assert(released.data == buffer && released.size == 3 && released.capacity == 4);
+        std::destroy_n(released.data, released.size);
+        alloc.deallocate(released.data, released.capacity);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> source(5);
+        Vector<Obj> target(2);
+        VectorBuffer<Obj> buffer = source.Release();
+        target.Adopt(buffer.data, buffer.size, buffer.capacity);
+        assert(Obj::num_copied == 0 && Obj::num_moved == 0);
+        assert(Obj::GetAliveObjectCount() == 5);
+    }
+#ifdef __cpp_lib_span
+    {
+        Vector<int> v{1, 2, 3};
+        const auto sum = [](std::span<const int> values) {
+            int result = 0;
+            for (int value : values) {
+                result += value;
+            }
+            return result;
+        };
+        assert(sum(v) == 6);
+
+        std::span<int> values = v;
+        values[0] = 10;
+        assert(v[0] == 10);
+    }
+#endif
+}
+
+void Test23() {
+    const size_t SIZE = 100000;
+    ParallelPolicy policy;
+    policy.threads = 4;
+    policy.min_chunk_bytes = 1024;
+    {
+        ConcurrentObj::ResetCounters();
+        Vector<ConcurrentObj> v(policy, SIZE);
+        assert(v.Size() == SIZE && ConcurrentObj::alive == static_cast<int>(SIZE));
+        assert(v[SIZE - 1].value == 7);
+
+        Vector<ConcurrentObj> copy(policy, v);
+        assert(ConcurrentObj::alive == static_cast<int>(2 * SIZE));
+
+        copy.Resize(policy, SIZE / 2);
+        assert(ConcurrentObj::alive == static_cast<int>(SIZE + SIZE / 2));
+        copy.Resize(policy, SIZE * 2);
+        assert(ConcurrentObj::alive == static_cast<int>(SIZE * 3));
+
+        v[0].value = 1;
+        copy.Assign(policy, v);
+        assert(copy.Size() == SIZE && copy[0].value == 1);
+        v.Resize(SIZE * 3);
+        copy.Assign(policy, v);
+        assert(copy.Size() == SIZE * 3);
+
+        copy.Clear(policy);
+        v.Clear(policy);
+        assert(ConcurrentObj::alive == 0);
+    }
+    {
+        // Исключение в одном куске уничтожает элементы всех остальных
+        ConcurrentObj::ResetCounters(static_cast<int>(SIZE / 2));
+        try {
+            Vector<ConcurrentObj> v(policy, SIZE);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(ConcurrentObj::alive == 0);
+
+        ConcurrentObj::ResetCounters();
+        Vector<ConcurrentObj> v(policy, SIZE);
+        ConcurrentObj::throw_after = static_cast<int>(SIZE + SIZE / 3);
+        try {
+            Vector<ConcurrentObj> copy(policy, v);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(ConcurrentObj::alive == static_cast<int>(SIZE));
+    }
+    {
+        Vector<int> ints(policy, SIZE * 10);
+        assert(std::all_of(ints.begin(), ints.end(), [](int x) {
+            return x == 0;
+        }));
+    }
+}
+
+void Test24() {
+    ParallelPolicy policy;
+    policy.threads = 4;
+    policy.min_chunk_bytes = 64 * 1024;
+    const size_t SIZE = 1 << 20;
+    {
+        Vector<int, NumaAllocator<int>> v(policy, SIZE);
+        assert(v[SIZE - 1] == 0);
+
+        Vector<int> nodes = NumaSliceNodes(policy, v.begin(), v.Size());
+        assert(nodes.Size() == 4);
+        for (int node : nodes) {
+            // В системе без поддержки NUMA узел неизвестен
+            assert(NumaNodeCount() == 0 ? node == -1 : node >= 0);
+        }
+    }
+    {
+        Vector<double, NumaAllocator<double, NumaPlacement::INTERLEAVE>> v(policy, SIZE);
+        v.PushBack(1.5);
+        assert(v.Size() == SIZE + 1 && v[SIZE] == 1.5);
+        v.Clear(policy);
+        v.ShrinkToFit();
+    }
+}
+
+void Test25() {
+    const int THREADS = 8;
+    const int PER_THREAD = 20000;
+    {
+        ConcurrentVector<int> v;
+        int& first = v.EmplaceBack(-1);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&v, t] {
+                for (int i = 0; i < PER_THREAD; ++i) {
+                    v.PushBack(t * PER_THREAD + i);
+                }
+                const size_t batch = v.GrowBy(100);
+                for (size_t i = batch; i < batch + 100; ++i) {
+                    assert(v[i] == 0);
+                    v[i] = -2;
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        // Рост не перемещает уже добавленные элементы
+        assert(&first == &v[0] && first == -1);
+        assert(v.Size() == static_cast<size_t>(1 + THREADS * (PER_THREAD + 100)));
+
+        std::vector<bool> seen(THREADS * PER_THREAD);
+        size_t batched = 0;
+        for (size_t i = 1; i < v.Size(); ++i) {
+            const int value = v[i];
+            if (value == -2) {
+                ++batched;
+            } else {
+                assert(!seen[value]);
+                seen[value] = true;
+            }
+        }
+        assert(batched == THREADS * 100);
+        assert(std::all_of(seen.begin(), seen.end(), [](bool b) {
+            return b;
+        }));
+    }
+    {
+        ConcurrentObj::ResetCounters(3);
+        ConcurrentVector<ConcurrentObj, std::allocator<ConcurrentObj>, 2> v;
+        v.EmplaceBack();
+        v.EmplaceBack();
+        try {
+            v.EmplaceBack();
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        v.EmplaceBack();
+        // Слот с исключением остаётся пустым
+        assert(v.Size() == 4);
+        assert(v.TryGet(2) == nullptr && v.TryGet(3) != nullptr);
+        assert(v.TryGet(100) == nullptr);
+        v.Clear();
+        assert(ConcurrentObj::alive == 0);
+    }
+}
+
+template <typename T>
+void CheckSimdKernels(SimdIsa isa) {
+    Vector<T, AlignedAllocator<T>> v(1000);
+    for (size_t i = 0; i < v.Size(); ++i) {
+        v[i] = static_cast<T>((i * 37) % 101);
+    }
+    v[500] = static_cast<T>(120);
+    v[501] = static_cast<T>(1);
+
+    // Смещённые начала проверяют скалярные прологи и хвосты
+    for (size_t offset : {0, 1, 3}) {
+        const T* p = v.begin() + offset;
+        const size_t n = v.Size() - offset * 7;
+
+        assert(SimdFind(p, n, static_cast<T>(120), isa) == 500 - offset);
+        assert(SimdFind(p, n, static_cast<T>(127), isa) == n);
+        assert(SimdCount(p, n, static_cast<T>(5), isa) == static_cast<size_t>(std::count(p, p + n, T(5))));
+
+        const std::pair<T, T> minmax = SimdMinMax(p, n, isa);
+        assert(minmax.first == *std::min_element(p, p + n));
+        assert(minmax.second == *std::max_element(p, p + n));
+
+        T expected = T{};
+        for (size_t i = 0; i < n; ++i) {
+            expected += p[i];
+        }
+        assert(SimdSum(p, n, isa) == expected);
+    }
+
+    Vector<T> filled(77);
+    SimdFill(filled.begin() + 1, 75, static_cast<T>(9), isa);
+    assert(filled[0] == T{} && filled[1] == T(9) && filled[75] == T(9) && filled[76] == T{});
+}
+
+void Test26() {
+    for (SimdIsa isa : {SimdIsa::SCALAR, SimdIsa::SSE2, SimdIsa::AVX2, SimdIsa::AVX512, SimdIsa::NEON}) {
+        if (!SimdIsaSupported(isa)) {
+            continue;
+        }
+        CheckSimdKernels<std::int8_t>(isa);
+        CheckSimdKernels<std::uint16_t>(isa);
+        CheckSimdKernels<int>(isa);
+        CheckSimdKernels<std::int64_t>(isa);
+        // Значения небольшие, поэтому суммы float и double точны в любом порядке
+        CheckSimdKernels<float>(isa);
+        CheckSimdKernels<double>(isa);
+    }
+    {
+        Vector<int> v(100000);
+        Fill(v, 3);
+        v[99999] = 4;
+        assert(Count(v, 3) == 99999);
+        assert(Find(v, 4) == v.begin() + 99999);
+        assert(Sum(v) == 3 * 99999 + 4);
+        assert(MinMax(v) == std::make_pair(3, 4));
+
+        Vector<int> out;
+        Transform(v, out, [](auto x) {
+            return x * 2 + 1;
+        });
+        assert(out.Size() == v.Size() && out[0] == 7 && out[99999] == 9);
+
+        Vector<float> f{1.0f, 2.0f, 3.0f};
+        Transform(f, f, [](auto x) {
+            return x * 0.5f;
+        });
+        assert(f[2] == 1.5f);
+    }
+}
+
+void Test27() {
+    {
+        SoaVector<int, std::string, double> v;
+        for (int i = 0; i < 100; ++i) {
+            v.EmplaceBack(i, std::to_string(i), i * 0.25);
+        }
+        assert(v.Size() == 100 && v.Capacity() == 128);
+        assert(std::get<1>(v[42]) == "42");
+
+        // Значение может ссылаться на элемент самого вектора
+        v.Reserve(v.Size());
+        v.Resize(128);
+        v.EmplaceBack(std::get<0>(v[5]), std::get<1>(v[5]), 1.0);
+        assert(std::get<1>(v[128]) == "5");
+
+        const int* ids = v.Data<0>();
+        int sum = 0;
+        for (size_t i = 0; i < 100; ++i) {
+            sum += ids[i];
+        }
+        assert(sum == 4950);
+
+        for (auto [id, name, value] : v) {
+            value += id;
+        }
+        assert(std::get<2>(v[10]) == 10.0 + 2.5);
+
+        v.Erase(v.begin() + 1);
+        assert(v.Size() == 128 && std::get<0>(v[1]) == 2 && std::get<1>(v[1]) == "2");
+        v.PopBack();
+        v.Resize(3);
+        assert(v.Size() == 3 && std::get<1>(v[2]) == "3");
+
+        SoaVector<int, std::string, double> copy(v);
+        assert(copy.Size() == 3 && std::get<1>(copy[2]) == "3");
+        SoaVector<int, std::string, double> moved(std::move(copy));
+        assert(moved.Size() == 3 && copy.Size() == 0);
+
+        const auto first = v.cbegin();
+        const auto last = v.cend();
+        assert(first <= last && last > first && last >= first && !(first > last) && first <= first);
+        assert(2 + first == first + 2 && std::get<0>(*(1 + v.begin())) == 2);
+
+#ifdef __cpp_lib_span
+        std::span<const double> values = std::as_const(v).Column<2>();
+        assert(values.size() == 3 && values[0] == 0.0);
+#endif
+    }
+    {
+        // Столбцы выделяются копиями аллокатора вектора, а Growth получает размер строки
+        using IntAlloc = TrackingAllocator<int, false>;
+        using DoubleAlloc = TrackingAllocator<double, false>;
+        const size_t int_bytes = IntAlloc::live_bytes;
+        const size_t double_bytes = DoubleAlloc::live_bytes;
+        {
+            BasicSoaVector<TrackingAllocator<char, false>, ShrinkingGrowth<MinCapacityGrowth<>>, int, double> v(
+                TrackingAllocator<char, false>(7));
+            v.EmplaceBack(0, 0.0);
+            assert(v.Capacity() == 64 / (sizeof(int) + sizeof(double)));
+            for (int i = 1; i < 16; ++i) {
+                v.EmplaceBack(i, i * 0.5);
+            }
+            const size_t capacity = v.Capacity();
+            assert(v.GetAllocator().id == 7);
+            assert(IntAlloc::live_bytes - int_bytes == capacity * sizeof(int));
+            assert(DoubleAlloc::live_bytes - double_bytes == capacity * sizeof(double));
+
+            auto copy = v;
+            assert(copy.GetAllocator().id == 7 && copy.Size() == 16);
+
+            // Удаление уменьшает буферы, как у Vector с ShrinkingGrowth
+            v.Resize(3);
+            assert(v.Capacity() < capacity && std::get<0>(v[2]) == 2 && std::get<1>(v[2]) == 1.0);
+            v.Clear();
+            copy.Clear();
+            assert(v.Capacity() == 0 && copy.Capacity() == 0);
+        }
+        assert(IntAlloc::live_bytes == int_bytes && DoubleAlloc::live_bytes == double_bytes);
+    }
+    {
+        // Копирование столбца бросает исключение при росте: вектор не меняется
+        ConcurrentObj::ResetCounters();
+        {
+            SoaVector<std::string, ConcurrentObj> v;
+            v.EmplaceBack("a", ConcurrentObj());
+            v.EmplaceBack("b", ConcurrentObj());
+            assert(v.Capacity() == 2);
+
+            ConcurrentObj::throw_after = ConcurrentObj::num_constructed + 3;
+            try {
+                v.EmplaceBack("c", ConcurrentObj());
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 2 && v.Capacity() == 2);
+            assert(std::get<0>(v[0]) == "a" && std::get<0>(v[1]) == "b");
+        }
+        assert(ConcurrentObj::alive == 0);
+    }
+    {
+        // Присваивание бросает исключение на каждом шаге сдвига по очереди:
+        // ни одна строка не уничтожается дважды
+        ThrowingMoveObj::alive = 0;
+        for (int countdown = 1;; ++countdown) {
+            {
+                SoaVector<ThrowingMoveObj, ThrowingMoveObj> v;
+                for (int i = 0; i < 3; ++i) {
+                    v.EmplaceBack(i, i * 10);
+                }
+                ThrowingMoveObj::assignments_before_throw = countdown;
+                try {
+                    v.Erase(v.begin());
+                    ThrowingMoveObj::assignments_before_throw = 0;
+                    assert(v.Size() == 2 && std::get<0>(v[0]).value == 1 && std::get<1>(v[1]).value == 20);
+                    assert(ThrowingMoveObj::alive == 4);
+                    break;
+                } catch (const std::runtime_error&) {
+                }
+                assert(v.Size() == 3 && ThrowingMoveObj::alive == 6);
+            }
+            assert(ThrowingMoveObj::alive == 0);
+        }
+        assert(ThrowingMoveObj::alive == 0);
+    }
+}
+
+void Test28() {
+    {
+        Vector<std::string> v;
+        for (int i = 0; i < 6; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        auto it = v.SwapErase(v.begin() + 1);
+        assert(v.Size() == 5 && *it == "5" && v[0] == "0" && v[4] == "4");
+        it = v.SwapErase(v.end() - 1);
+        assert(v.Size() == 4 && it == v.end());
+
+        // Диапазон длиннее хвоста: переезжает только хвост
+        it = v.UnorderedErase(v.begin() + 1, v.begin() + 3);
+        assert(v.Size() == 2 && v[0] == "0" && v[1] == "3" && *it == "3");
+    }
+    {
+        Vector<int> v{0, 1, 2, 3, 4, 5, 6};
+        v.UnorderedErase(v.begin(), v.begin() + 2);
+        const std::array<int, 5> expected{5, 6, 2, 3, 4};
+        assert(v.Size() == 5 && std::equal(v.begin(), v.end(), expected.begin()));
+        v.UnorderedErase(v.begin() + 2, v.end());
+        assert(v.Size() == 2 && v[0] == 5 && v[1] == 6);
+    }
+    {
+        SlotMap<std::string> map;
+        Vector<SlotHandle> handles;
+        for (int i = 0; i < 10; ++i) {
+            handles.PushBack(map.Insert(std::to_string(i)));
+        }
+        assert(map.Size() == 10 && map[handles[7]] == "7");
+
+        assert(map.Erase(handles[3]));
+        assert(!map.Erase(handles[3]));
+        assert(!map.Contains(handles[3]) && map.Find(handles[3]) == nullptr);
+        assert(map.Size() == 9 && map[handles[9]] == "9" && map[handles[4]] == "4");
+
+        // Освободившийся слот достаётся новому элементу с другим поколением
+        const SlotHandle reused = map.Insert("new");
+        assert(reused.index == handles[3].index && reused != handles[3]);
+        assert(map.Find(handles[3]) == nullptr && map[reused] == "new");
+
+        for (size_t i = 0; i < map.Size(); ++i) {
+            assert(&map[map.HandleAt(i)] == map.Data() + i);
+        }
+
+        int sum = 0;
+        for (const std::string& value : map) {
+            sum += value == "new" ? 0 : std::stoi(value);
+        }
+        assert(sum == 45 - 3);
+
+        map.Clear();
+        assert(map.Empty() && !map.Contains(handles[0]) && !map.Contains(reused));
+        assert(!map.Contains(SlotHandle()));
+    }
+    {
+        // Конструктор бросает исключение: ключи и элементы остаются прежними
+        ConcurrentObj::ResetCounters();
+        {
+            SlotMap<ConcurrentObj> map;
+            const SlotHandle first = map.Emplace();
+            ConcurrentObj::throw_after = ConcurrentObj::num_constructed + 1;
+            try {
+                map.Insert(map[first]);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(map.Size() == 1 && map.Contains(first));
+            assert(map.HandleAt(0) == first);
+        }
+        assert(ConcurrentObj::alive == 0);
+    }
+}
+
+void Test29() {
+    {
+        ChunkedVector<std::string, std::allocator<std::string>, 4> v;
+        v.PushBack("0");
+        const std::string* first = &v[0];
+        for (int i = 1; i < 10; ++i) {
+            // Элемент самого вектора годится как значение: при росте он не переезжает
+            v.EmplaceBack(v[0]).append(std::to_string(i));
+        }
+        assert(&v[0] == first);
+        assert(v.Size() == 10 && v.ChunkCount() == 3 && v.Capacity() == 12);
+        assert(v[9] == "09" && *(v.begin() + 5) == "05" && v.end() - v.begin() == 10);
+
+        size_t runs = 0;
+        size_t total = 0;
+        v.ForEachChunk([&](const std::string* run_first, const std::string* run_last) {
+            ++runs;
+            total += run_last - run_first;
+        });
+        assert(runs == 3 && total == 10);
+
+        auto it = std::find(v.begin(), v.end(), "06");
+        assert(it - v.begin() == 6 && it.ChunkEnd() == &*it + 2);
+        std::sort(v.begin(), v.end(), std::greater<>());
+        assert(v[0] == "09" && v[9] == "0");
+
+        // Участок последнего, неполного куска обрывается на последнем элементе
+        auto tail = v.begin() + 8;
+        assert(tail.ChunkEnd() == &v[9] + 1 && (v.cend() - 1).ChunkEnd() == &v[9] + 1);
+        assert(std::distance(&*tail, tail.ChunkEnd()) == v.end() - tail);
+        assert(v.cbegin() <= tail && tail > v.begin() && v.end() >= tail && !(tail >= v.end()));
+        assert(8 + v.begin() == tail && *(2 + v.cbegin()) == "07");
+
+        // Удаление с начала освобождает куски, не двигая остальные элементы
+        const std::string* sixth = &v[6];
+        v.EraseFront(5);
+        assert(v.Size() == 5 && v.ChunkCount() == 2 && &v[1] == sixth && v[0] == "04");
+        assert(v.begin().ChunkEnd() == &v[0] + 3 && (v.begin() + 3).ChunkEnd() == &v[4] + 1);
+
+        v.PopBack();
+        v.PopBack();
+        assert(v.Size() == 3 && v.ChunkCount() == 2);
+        v.ShrinkToFit();
+        assert(v.ChunkCount() == 1 && v[2] == "02");
+
+        ChunkedVector<std::string, std::allocator<std::string>, 4> copy(v);
+        assert(copy.Size() == 3 && copy[0] == "04" && copy[2] == "02");
+        copy.Resize(9);
+        assert(copy.Size() == 9 && copy[8].empty());
+        v = std::move(copy);
+        assert(v.Size() == 9 && copy.Size() == 0);
+        v.Clear();
+        assert(v.Empty() && v.Capacity() == 12);
+    }
+    {
+        // Конструктор бросает исключение: размер и элементы остаются прежними
+        ConcurrentObj::ResetCounters();
+        {
+            ChunkedVector<ConcurrentObj, std::allocator<ConcurrentObj>, 2> v(3);
+            ConcurrentObj::throw_after = ConcurrentObj::num_constructed + 2;
+            try {
+                v.Resize(6);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 3 && ConcurrentObj::alive == 3);
+            try {
+                ConcurrentObj::throw_after = ConcurrentObj::num_constructed + 1;
+                v.PushBack(v[0]);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 3 && ConcurrentObj::alive == 3);
+        }
+        assert(ConcurrentObj::alive == 0);
+    }
+}
+
+void Test30() {
+    {
+        CowVector<std::string> v{"a", "b", "c"};
+        CowVector<std::string> snapshot = v.Snapshot();
+        assert(v.UseCount() == 2 && &std::as_const(v)[0] == &std::as_const(snapshot)[0]);
+
+        // Первая запись отделяет буфер, снимок не меняется
+        v.PushBack(std::as_const(v)[0]);
+        assert(v.UseCount() == 1 && snapshot.UseCount() == 1);
+        assert(v.Size() == 4 && v[3] == "a" && snapshot.Size() == 3);
+
+        v[0] = "x";
+        assert(std::as_const(snapshot)[0] == "a");
+
+        CowVector<std::string> copy = snapshot;
+        copy.Clear();
+        assert(copy.Size() == 0 && snapshot.Size() == 3 && snapshot.UseCount() == 1);
+
+        const std::string* before = &std::as_const(v)[1];
+        v.Erase(v.cbegin() + 1);
+        assert(v.Size() == 3 && v[1] == "c" && &std::as_const(v)[0] == before - 1);
+    }
+    {
+        // Отделение перед вставкой сразу берёт запас ёмкости: элементы копируются один раз
+        CowVector<Obj> v;
+        for (int i = 0; i < 3; ++i) {
+            v.EmplaceBack(i);
+        }
+        CowVector<Obj> snapshot = v.Snapshot();
+        Obj::ResetCounters();
+        v.PushBack(Obj(3));
+        assert(Obj::num_copied == 3 && Obj::num_moved == 1 && v.Capacity() > v.Size());
+        assert(v[3].id == 3 && snapshot.Size() == 3);
+
+        CowVector<int> reserved{1, 2};
+        CowVector<int> reserved_snapshot = reserved;
+        reserved.Reserve(100);
+        assert(reserved.Capacity() == 100 && reserved.UseCount() == 1 && reserved_snapshot.UseCount() == 1);
+    }
+    {
+        // Снимки читаются в других потоках, пока владелец пишет в свою копию
+        CowVector<int> v(Vector<int>(1000));
+        Vector<std::thread> readers;
+        std::atomic<int> total = 0;
+        for (int i = 0; i < 4; ++i) {
+            readers.EmplaceBack([snapshot = v.Snapshot(), &total] {
+                int sum = 0;
+                for (int x : snapshot) {
+                    sum += x;
+                }
+                total += sum;
+            });
+        }
+        for (int i = 0; i < 1000; ++i) {
+            v[i] = 1;
+        }
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        assert(total == 0 && std::accumulate(v.cbegin(), v.cend(), 0) == 1000);
+    }
+    {
+        // Копирование при записи бросает исключение: вектор и снимок не меняются
+        ConcurrentObj::ResetCounters();
+        {
+            CowVector<ConcurrentObj> v(3);
+            CowVector<ConcurrentObj> snapshot = v;
+            ConcurrentObj::throw_after = ConcurrentObj::num_constructed + 2;
+            try {
+                v.PopBack();
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 3 && v.UseCount() == 2 && ConcurrentObj::alive == 3);
+        }
+        assert(ConcurrentObj::alive == 0);
+    }
+}
+
+void Test31() {
+    {
+        // Три уровня дерева и хвост
+        const size_t SIZE = 40000;
+        ImmutableVector<int>::Transient transient;
+        for (size_t i = 0; i < SIZE; ++i) {
+            transient.PushBack(static_cast<int>(i));
+        }
+        const ImmutableVector<int> base = transient.Persistent();
+        assert(base.Size() == SIZE && transient.Size() == 0);
+        for (size_t i = 0; i < SIZE; i += 997) {
+            assert(base[i] == static_cast<int>(i));
+        }
+        assert(std::accumulate(base.begin(), base.end(), size_t{0}) == SIZE * (SIZE - 1) / 2);
+        const auto middle = base.begin() + 20000;
+        assert(base.begin() <= middle && middle > base.begin() && base.end() >= middle && !(middle >= base.end()));
+        assert(20000 + base.begin() == middle && *(7 + middle) == 20007);
+        assert(std::lower_bound(base.begin(), base.end(), 31415) - base.begin() == 31415);
+
+        // Версии не влияют друг на друга
+        const ImmutableVector<int> changed = base.Set(12345, -1).PushBack(-2);
+        assert(changed.Size() == SIZE + 1 && changed[12345] == -1 && changed[SIZE] == -2);
+        assert(base.Size() == SIZE && base[12345] == 12345);
+        assert(&changed[0] == &base[0] && &changed[12345 - 32] == &base[12345 - 32]);
+
+        const Vector<int> plain = changed.ToVector();
+        assert(plain.Size() == SIZE + 1 && plain[12345] == -1);
+        const ImmutableVector<int> round_trip(plain);
+        assert(round_trip.Size() == SIZE + 1 && round_trip[SIZE] == -2);
+    }
+    {
+        ImmutableVector<std::string> v{"a", "b"};
+        const ImmutableVector<std::string> first = v;
+        for (int i = 0; i < 100; ++i) {
+            // Значение может ссылаться на элемент самой версии
+            v = v.PushBack(v[i]);
+        }
+        assert(v.Size() == 102 && v[101] == "b" && first.Size() == 2);
+
+        auto transient = v.MakeTransient();
+        transient.Set(5, "x");
+        assert(transient[5] == "x" && v[5] == "b");
+        transient.Set(5, transient[4]);
+        const ImmutableVector<std::string> edited = transient.Persistent();
+        assert(edited[5] == "a" && v[5] == "b");
+
+        size_t chunks = 0;
+        edited.ForEachChunk([&chunks](const std::string* first, const std::string* last) {
+            assert(last - first == (chunks < 3 ? 32 : 6));
+            ++chunks;
+        });
+        assert(chunks == 4);
+    }
+    {
+        // Конструктор бросает исключение: версия не меняется, узлы не утекают
+        ConcurrentObj::ResetCounters();
+        {
+            ImmutableVector<ConcurrentObj>::Transient transient;
+            for (int i = 0; i < 64; ++i) {
+                transient.EmplaceBack();
+            }
+            const ImmutableVector<ConcurrentObj> v = transient.Persistent();
+            ConcurrentObj::throw_after = ConcurrentObj::num_constructed + 1;
+            try {
+                (void)v.EmplaceBack();
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            ConcurrentObj::throw_after = ConcurrentObj::num_constructed + 10;
+            try {
+                (void)v.Set(63, ConcurrentObj());
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 64 && ConcurrentObj::alive == 64);
+        }
+        assert(ConcurrentObj::alive == 0);
+    }
+}
+
+#ifdef ADVANCED_VECTOR_HAS_CONSTEXPR
+// Вектор целиком создаётся, растёт и уничтожается при компиляции
+constexpr int ConstexprVectorSum() {
+    Vector<int> v;
+    for (int i = 0; i < 100; ++i) {
+        v.PushBack(i);
+    }
+    v.Resize(50);
+    Vector<int> copy = v;
+    copy.PopBack();
+    Vector<int> moved = std::move(copy);
+    moved.Reserve(1000);
+
+    int sum = 0;
+    for (int x : moved) {
+        sum += x;
+    }
+    return sum + static_cast<int>(v.Size());
+}
+
+constexpr StaticVector<int, 16> ConstexprSquares() {
+    StaticVector<int, 16> squares;
+    while (squares.TryPushBack(static_cast<int>(squares.Size() * squares.Size())) != nullptr) {
+    }
+    squares.SwapErase(squares.begin());
+    return squares;
+}
+#endif
+
+void Test32() {
+#ifdef ADVANCED_VECTOR_HAS_CONSTEXPR
+    static_assert(ConstexprVectorSum() == 49 * 48 / 2 + 50);
+
+    constexpr StaticVector<int, 16> squares = ConstexprSquares();
+    static_assert(squares.Size() == 15 && squares[0] == 225 && squares[14] == 196);
+#endif
+    static_assert(StaticVector<int, 8>::CAPACITY == 8 && StaticVector<int, 8>::Capacity() == 8);
+    static_assert(std::is_trivially_copyable_v<StaticVector<int, 8>>);
+
+    {
+        StaticVector<std::string, 4> v{"a", "b"};
+        v.EmplaceBack(3, 'c');
+        v.PushBack(v[0]);
+        assert(v.Full() && v[2] == "ccc" && v[3] == "a");
+        assert(v.TryPushBack("e") == nullptr);
+        try {
+            v.PushBack("e");
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        assert(v.Size() == 4);
+
+        StaticVector<std::string, 4> copy = v;
+        v.Erase(v.begin());
+        assert(v.Size() == 3 && v[0] == "b" && copy[0] == "a");
+        copy = v;
+        assert(copy.Size() == 3 && copy[2] == "a");
+        v.Resize(1);
+        copy = std::move(v);
+        assert(copy.Size() == 1 && copy[0] == "b");
+        copy.Clear();
+        assert(copy.Empty());
+
+        try {
+            StaticVector<int, 2> too_long{1, 2, 3};
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+    }
+    {
+        ConcurrentObj::ResetCounters();
+        {
+            StaticVector<ConcurrentObj, 8> v(2);
+            ConcurrentObj::throw_after = ConcurrentObj::num_constructed + 2;
+            try {
+                v.Resize(5);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 3 && ConcurrentObj::alive == 3);
+        }
+        assert(ConcurrentObj::alive == 0);
+    }
+}
+
+void Test33() {
+    using Alloc = TrackingAllocator<int, false>;
+    {
+        RawMemory<int, Alloc> memory(8);
+        memory = RawMemory<int, Alloc>(4);
+        assert(memory.Capacity() == 4);
+        assert(Alloc::live_bytes == 4 * sizeof(int));
+    }
+    assert(Alloc::live_bytes == 0);
+    {
+        // Сдвиг хвоста прерывается, когда элемент за концом уже сконструирован
+        ThrowingMoveObj::alive = 0;
+        {
+            Vector<ThrowingMoveObj> v;
+            v.Reserve(4);
+            for (int i = 0; i < 3; ++i) {
+                v.EmplaceBack(i);
+            }
+            ThrowingMoveObj::assignments_before_throw = 1;
+            try {
+                v.Emplace(v.begin(), 10);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 3);
+            assert(ThrowingMoveObj::alive == 3);
+        }
+        assert(ThrowingMoveObj::alive == 0);
+    }
+}
+
+void Test34() {
+    using Stats = RegisteredVectorStats<RegistryTag>;
+    using TaggedVector = Vector<int, std::allocator<int>, DoublingGrowth, Stats>;
+    {
+        TaggedVector v;
+        assert(v.MemoryUsage() == 0);
+        v.Reserve(10);
+        v.PushBack(1);
+        assert(v.MemoryUsage() == 10 * sizeof(int));
+
+        VectorRegistryRecord record = Stats::Snapshot();
+        assert(record.live_vectors == 1);
+        assert(record.live_bytes == 10 * sizeof(int));
+        assert(record.slack_bytes == 9 * sizeof(int));
+
+        TaggedVector copy(v);
+        v.ShrinkToFit();
+        record = Stats::Snapshot();
+        assert(record.live_vectors == 2);
+        assert(record.live_bytes == 2 * sizeof(int));
+        assert(record.slack_bytes == 0);
+
+        copy.Reserve(4);
+        TaggedVector moved(std::move(copy));
+        v = std::move(moved);
+        v.Swap(copy);
+        record = Stats::Snapshot();
+        assert(record.live_vectors == 3);
+        assert(record.live_bytes == 4 * sizeof(int));
+        assert(record.slack_bytes == 3 * sizeof(int));
+
+        std::ostringstream out;
+        VectorRegistry::Dump(out);
+        const std::string line = "registry-test vectors=3 live_bytes=" + std::to_string(4 * sizeof(int))
+                                 + " slack_bytes=" + std::to_string(3 * sizeof(int)) + "\n";
+        assert(out.str().find(line) != std::string::npos);
+    }
+    {
+        // Незанятая ёмкость следует за размером и без смены буфера
+        TaggedVector v;
+        v.Reserve(8);
+        assert(Stats::Snapshot().slack_bytes == 8 * sizeof(int));
+        for (int i = 0; i < 8; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Capacity() == 8 && Stats::Snapshot().slack_bytes == 0);
+
+        v.PopBack();
+        v.Erase(v.begin());
+        assert(Stats::Snapshot().slack_bytes == 2 * sizeof(int));
+        v.Insert(v.begin(), {7, 8});
+        assert(Stats::Snapshot().slack_bytes == 0);
+        v.Resize(5);
+        assert(Stats::Snapshot().slack_bytes == 3 * sizeof(int));
+        v.Clear();
+        assert(Stats::Snapshot().slack_bytes == 8 * sizeof(int));
+        v.ShrinkToFit();
+        assert(Stats::Snapshot().slack_bytes == 0 && Stats::Snapshot().live_bytes == 0);
     }
+    const VectorRegistryRecord record = Stats::Snapshot();
+    assert(record.live_vectors == 0 && record.live_bytes == 0 && record.slack_bytes == 0);
 }
 
 int main() {
@@ -647,7 +2430,34 @@ int main() {
         Test4();
         Test5();
         Test6();
-        Benchmark();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+        Test29();
+        Test30();
+        Test31();
+        Test32();
+        Test33();
+        Test34();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
@@ -0,0 +1,253 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Вектор побайтово копируемых записей, хранящийся в отображённом в память файле.
+// Открытие существующего файла не читает его: элементы доступны сразу, а страницы
+// подгружаются ядром по мере обращения. Файл растёт через ftruncate и mremap,
+// поэтому, как и у Vector, рост делает недействительными указатели на элементы.
+// Изменения попадают в файл при выгрузке страниц ядром, Flush() записывает их сразу.
+// Перемещённый вектор пуст и не связан с файлом: его можно читать, очищать,
+// сбрасывать Flush(), уничтожать и присваивать ему другой вектор
+template <typename T, typename Growth = DoublingGrowth>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector stores the bytes of its elements in a file");
+    static_assert(alignof(T) <= 64, "Elements are stored right after a 64-byte header");
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    // Открывает файл или создаёт его, если он не существует
+    explicit MappedVector(const std::string& path) {
+        fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            ThrowSystemError("open " + path);
+        }
+
+        try {
+            struct stat st;
+            if (fstat(fd_, &st) != 0) {
+                ThrowSystemError("fstat " + path);
+            }
+
+            if (st.st_size == 0) {
+                GrowFile(0, INITIAL_BYTES);
+                *header_ = Header{};
+            } else {
+                if (static_cast<size_t>(st.st_size) < sizeof(Header)) {
+                    throw std::runtime_error(path + " is not a MappedVector file");
+                }
+                Map(static_cast<size_t>(st.st_size));
+                ValidateHeader(path);
+            }
+        } catch (...) {
+            Unmap();
+            close(fd_);
+            throw;
+        }
+    }
+
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+
+    MappedVector(MappedVector&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1))
+        , header_(std::exchange(other.header_, nullptr))
+        , length_(std::exchange(other.length_, 0))
+    {}
+
+    MappedVector& operator=(MappedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            MappedVector temp(std::move(rhs));
+            std::swap(fd_, temp.fd_);
+            std::swap(header_, temp.header_);
+            std::swap(length_, temp.length_);
+        }
+        return *this;
+    }
+
+    ~MappedVector() {
+        if (fd_ >= 0) {
+            Unmap();
+            close(fd_);
+        }
+    }
+
+    iterator begin() noexcept {
+        return Data();
+    }
+
+    iterator end() noexcept {
+        return Data() + Size();
+    }
+
+    const_iterator begin() const noexcept {
+        return Data();
+    }
+
+    const_iterator end() const noexcept {
+        return Data() + Size();
+    }
+
+    size_t Size() const noexcept {
+        return header_ != nullptr ? static_cast<size_t>(header_->size) : 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return header_ != nullptr ? (length_ - sizeof(Header)) / sizeof(T) : 0;
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Size());
+        return Data()[index];
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<MappedVector&>(*this)[index];
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        if (new_capacity > (static_cast<size_t>(-1) - sizeof(Header)) / sizeof(T)) {
+            throw std::length_error("MappedVector capacity is too large");
+        }
+
+        GrowFile(length_, sizeof(Header) + new_capacity * sizeof(T));
+    }
+
+    void Resize(size_t new_size) {
+        const size_t old_size = Size();
+        if (new_size > old_size) {
+            Reserve(new_size);
+            std::uninitialized_value_construct_n(Data() + old_size, new_size - old_size);
+        }
+        header_->size = new_size;
+    }
+
+    void Clear() noexcept {
+        if (header_ != nullptr) {
+            header_->size = 0;
+        }
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        const size_t size = Size();
+        if (size == Capacity()) {
+            // Аргументы могут ссылаться на элемент, который переедет при mremap
+            T value(std::forward<Args>(args)...);
+            Reserve(Growth::NewCapacity(size, size + 1, sizeof(T)));
+            new (Data() + size) T(value);
+        } else {
+            new (Data() + size) T(std::forward<Args>(args)...);
+        }
+
+        header_->size = size + 1;
+        return Data()[size];
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PopBack() noexcept {
+        assert(Size() != 0);
+        --header_->size;
+    }
+
+    // Синхронно записывает изменённые страницы и размер в файл
+    void Flush() {
+        if (header_ != nullptr && msync(header_, length_, MS_SYNC) != 0) {
+            ThrowSystemError("msync");
+        }
+    }
+
+private:
+    static constexpr std::uint64_t MAGIC = 0x314345564450414dULL;  // "MAPDVEC1"
+    static constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+    static constexpr size_t INITIAL_BYTES = 4096;
+
+    struct alignas(64) Header {
+        std::uint64_t magic = MAGIC;
+        std::uint32_t byte_order = BYTE_ORDER_MARK;
+        std::uint32_t element_size = sizeof(T);
+        std::uint64_t size = 0;
+    };
+
+    T* Data() const noexcept {
+        return header_ != nullptr ? reinterpret_cast<T*>(header_ + 1) : nullptr;
+    }
+
+    void ValidateHeader(const std::string& path) const {
+        if (header_->magic != MAGIC || header_->byte_order != BYTE_ORDER_MARK) {
+            throw std::runtime_error(path + " is not a MappedVector file of this byte order");
+        }
+        if (header_->element_size != sizeof(T)) {
+            throw std::runtime_error(path + " stores elements of a different size");
+        }
+        if (header_->size > Capacity()) {
+            throw std::runtime_error(path + " is truncated");
+        }
+    }
+
+    void Map(size_t length) {
+        void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) {
+            ThrowSystemError("mmap");
+        }
+        header_ = static_cast<Header*>(p);
+        length_ = length;
+    }
+
+    void Unmap() noexcept {
+        if (header_ != nullptr) {
+            munmap(header_, length_);
+            header_ = nullptr;
+        }
+    }
+
+    // Увеличивает файл до new_length байт и отображение вслед за ним
+    void GrowFile(size_t old_length, size_t new_length) {
+        if (ftruncate(fd_, static_cast<off_t>(new_length)) != 0) {
+            ThrowSystemError("ftruncate");
+        }
+
+        if (old_length == 0) {
+            Map(new_length);
+            return;
+        }
+
+        void* p = mremap(header_, old_length, new_length, MREMAP_MAYMOVE);
+        if (p == MAP_FAILED) {
+            const int error = errno;
+            // Возвращаем файлу прежний размер, чтобы он соответствовал отображению
+            [[maybe_unused]] int result = ftruncate(fd_, static_cast<off_t>(old_length));
+            throw std::system_error(error, std::generic_category(), "mremap");
+        }
+        header_ = static_cast<Header*>(p);
+        length_ = new_length;
+    }
+
+    [[noreturn]] static void ThrowSystemError(const std::string& what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    int fd_ = -1;
+    Header* header_ = nullptr;
+    size_t length_ = 0;
+};
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "vector.h"
+
+#if defined(__linux__) && __has_include(<linux/mempolicy.h>)
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define ADVANCED_VECTOR_NUMA 1
+#endif
+
+// Как распределять страницы буфера по узлам NUMA.
+// FIRST_TOUCH: страницы не трогаются при выделении, и каждая попадает на узел потока,
+// который обратится к ней первым. Вместе с параллельным конструктором вектора
+// каждый кусок оказывается на узле потока, который его сконструировал.
+// INTERLEAVE: страницы чередуются по всем разрешённым узлам, что выравнивает
+// нагрузку на память, если заранее неизвестно, какие потоки будут читать буфер
+enum class NumaPlacement {
+    FIRST_TOUCH,
+    INTERLEAVE,
+};
+
+#ifdef ADVANCED_VECTOR_NUMA
+// Маска узлов, на которых процессу разрешено выделять память. Ядро поддерживает
+// до 1024 узлов; если системный вызов недоступен, маска пуста
+struct NumaNodeMask {
+    static constexpr size_t MAX_NODES = 1024;
+    static constexpr size_t BITS_PER_WORD = 8 * sizeof(unsigned long);
+
+    unsigned long words[MAX_NODES / BITS_PER_WORD] = {};
+
+    static const NumaNodeMask& Allowed() noexcept {
+        static const NumaNodeMask mask = [] {
+            NumaNodeMask result;
+            if (syscall(SYS_get_mempolicy, nullptr, result.words, MAX_NODES, nullptr, MPOL_F_MEMS_ALLOWED) != 0) {
+                result = NumaNodeMask();
+            }
+            return result;
+        }();
+        return mask;
+    }
+
+    size_t Count() const noexcept {
+        size_t count = 0;
+        for (unsigned long word : words) {
+            count += static_cast<size_t>(__builtin_popcountl(word));
+        }
+        return count;
+    }
+};
+#endif
+
+// Число узлов NUMA, доступных процессу; 0, если система не сообщает его
+inline size_t NumaNodeCount() noexcept {
+#ifdef ADVANCED_VECTOR_NUMA
+    return NumaNodeMask::Allowed().Count();
+#else
+    return 0;
+#endif
+}
+
+// Узел, на котором лежит страница с адресом p, или -1, если он неизвестен.
+// Ещё не выделенная страница при этом выделяется
+inline int NumaNodeOf(const void* p) noexcept {
+#ifdef ADVANCED_VECTOR_NUMA
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0, p, MPOL_F_NODE | MPOL_F_ADDR) == 0) {
+        return node;
+    }
+#else
+    (void)p;
+#endif
+    return -1;
+}
+
+// Буферы выделяются через mmap целыми страницами, поэтому аллокатор рассчитан на
+// большие векторы. Если ядро не поддерживает политики NUMA, INTERLEAVE
+// молча превращается в FIRST_TOUCH, то есть в обычное поведение
+template <typename T, NumaPlacement Placement = NumaPlacement::FIRST_TOUCH>
+struct NumaAllocator {
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = NumaAllocator<U, Placement>;
+    };
+
+    NumaAllocator() = default;
+
+    template <typename U>
+    NumaAllocator(const NumaAllocator<U, Placement>& /*other*/) noexcept {}
+
+#ifdef ADVANCED_VECTOR_NUMA
+    T* allocate(size_t n) {
+        const size_t length = LengthFor(n);
+        void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+
+        if constexpr (Placement == NumaPlacement::INTERLEAVE) {
+            const NumaNodeMask& mask = NumaNodeMask::Allowed();
+            if (mask.Count() > 1) {
+                // Ошибка не критична: страницы просто разместятся по первому касанию
+                syscall(SYS_mbind, p, length, MPOL_INTERLEAVE, mask.words, NumaNodeMask::MAX_NODES, 0);
+            }
+        }
+
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        munmap(p, LengthFor(n));
+    }
+#else
+    T* allocate(size_t n) {
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        std::allocator<T>().deallocate(p, n);
+    }
+#endif
+
+    friend bool operator==(const NumaAllocator&, const NumaAllocator&) noexcept {
+        return true;
+    }
+
+    friend bool operator!=(const NumaAllocator&, const NumaAllocator&) noexcept {
+        return false;
+    }
+
+private:
+#ifdef ADVANCED_VECTOR_NUMA
+    static size_t LengthFor(size_t n) {
+        static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        if (n > (static_cast<size_t>(-1) - page_size) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return (n * sizeof(T) + page_size - 1) / page_size * page_size;
+    }
+#endif
+};
+
+// Узел NUMA первой страницы каждого куска, на которые policy делит count элементов,
+// начиная с data. Куски те же, что обрабатывают потоки параллельных операций вектора
+template <typename T>
+Vector<int> NumaSliceNodes(const ParallelPolicy& policy, const T* data, size_t count) {
+    const size_t chunks = ParallelChunkCount(policy, count, sizeof(T));
+
+    Vector<int> nodes;
+    nodes.Reserve(chunks);
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        const size_t begin = ParallelChunkBegin(count, chunks, chunk);
+        nodes.PushBack(begin < count ? NumaNodeOf(data + begin) : -1);
+    }
+    return nodes;
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+// Разрешает выполнять массовые операции над элементами в нескольких потоках.
+// Диапазон делится на куски не меньше min_chunk_bytes байт, не больше одного на поток
+struct ParallelPolicy {
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t min_chunk_bytes = size_t{1} << 20;
+};
+
+// Число кусков, на которые делится диапазон из count элементов
+inline size_t ParallelChunkCount(const ParallelPolicy& policy, size_t count, size_t element_size) noexcept {
+    const size_t min_chunk = std::max<size_t>(1, policy.min_chunk_bytes / std::max<size_t>(1, element_size));
+    return std::max<size_t>(1, std::min(policy.threads, count / min_chunk));
+}
+
+// Индекс первого элемента куска chunk; куски отличаются по длине не больше чем на один
+inline size_t ParallelChunkBegin(size_t count, size_t chunks, size_t chunk) noexcept {
+    return count / chunks * chunk + std::min(chunk, count % chunks);
+}
+
+// Выполняет work(begin, end) над кусками [0, count). Первый кусок обрабатывает
+// вызывающий поток. Если какой-то кусок бросил исключение, для всех успешно
+// обработанных кусков вызывается undo(begin, end), после чего исключение
+// первого неудачного куска пробрасывается дальше
+template <typename Work, typename Undo>
+void ParallelChunks(const ParallelPolicy& policy, size_t count, size_t element_size, Work work, Undo undo) {
+    const size_t chunks = ParallelChunkCount(policy, count, element_size);
+
+    if (chunks == 1) {
+        work(size_t{0}, count);
+        return;
+    }
+
+    const auto chunk_begin = [count, chunks](size_t chunk) {
+        return ParallelChunkBegin(count, chunks, chunk);
+    };
+
+    std::unique_ptr<std::exception_ptr[]> errors(new std::exception_ptr[chunks]);
+    const auto run = [&](size_t chunk) {
+        try {
+            work(chunk_begin(chunk), chunk_begin(chunk + 1));
+        } catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    };
+
+    std::unique_ptr<std::thread[]> threads(new std::thread[chunks]);
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        try {
+            threads[chunk] = std::thread(run, chunk);
+        } catch (...) {
+            // Потоков не хватило: оставшуюся работу сделает вызывающий поток
+            run(chunk);
+        }
+    }
+
+    run(0);
+
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        if (threads[chunk].joinable()) {
+            threads[chunk].join();
+        }
+    }
+
+    std::exception_ptr error;
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        if (errors[chunk] && !error) {
+            error = errors[chunk];
+        }
+    }
+
+    if (error) {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            if (!errors[chunk]) {
+                undo(chunk_begin(chunk), chunk_begin(chunk + 1));
+            }
+        }
+        std::rethrow_exception(error);
+    }
+}
+
+// Параллельные аналоги std::uninitialized_value_construct_n, std::uninitialized_copy_n
+// и std::destroy_n. При исключении уже сконструированные элементы уничтожаются
+template <typename T>
+void ParallelUninitializedValueConstructN(const ParallelPolicy& policy, T* first, size_t count) {
+    ParallelChunks(
+        policy, count, sizeof(T),
+        [first](size_t begin, size_t end) {
+            std::uninitialized_value_construct(first + begin, first + end);
+        },
+        [first](size_t begin, size_t end) {
+            std::destroy(first + begin, first + end);
+        });
+}
+
+template <typename T>
+void ParallelUninitializedCopyN(const ParallelPolicy& policy, const T* source, size_t count, T* first) {
+    ParallelChunks(
+        policy, count, sizeof(T),
+        [source, first](size_t begin, size_t end) {
+            std::uninitialized_copy(source + begin, source + end, first + begin);
+        },
+        [first](size_t begin, size_t end) {
+            std::destroy(first + begin, first + end);
+        });
+}
+
+template <typename T>
+void ParallelCopyN(const ParallelPolicy& policy, const T* source, size_t count, T* first) {
+    ParallelChunks(
+        policy, count, sizeof(T),
+        [source, first](size_t begin, size_t end) {
+            std::copy(source + begin, source + end, first + begin);
+        },
+        [](size_t /*begin*/, size_t /*end*/) {});
+}
+
+template <typename T>
+void ParallelDestroyN(const ParallelPolicy& policy, T* first, size_t count) noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        // Деструкторы не бросают исключений, поэтому откатывать нечего. ParallelChunks
+        // может бросить bad_alloc только до начала работы, и тогда элементы уничтожаются здесь
+        try {
+            ParallelChunks(
+                policy, count, sizeof(T),
+                [first](size_t begin, size_t end) {
+                    std::destroy(first + begin, first + end);
+                },
+                [](size_t /*begin*/, size_t /*end*/) {});
+        } catch (...) {
+            std::destroy_n(first, count);
+        }
+    }
+}
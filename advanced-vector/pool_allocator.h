@@ -0,0 +1,219 @@
+#pragma once
+
+#include "vector.h"
+
+#include <mutex>
+
+// Пул блоков размером в степень двойки от 16 байт до 1 МиБ. У каждого потока свой
+// кэш свободных блоков каждого класса, работа с ним не требует синхронизации.
+// Переполненный кэш отдаёт пачку блоков в общее хранилище, опустевший забирает
+// пачку оттуда. Блоки крупнее MAX_BLOCK_SIZE выделяются напрямую через operator new
+class Pool {
+public:
+    static constexpr size_t MIN_CLASS_SHIFT = 4;
+    static constexpr size_t MAX_CLASS_SHIFT = 20;
+    static constexpr size_t CLASS_COUNT = MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1;
+    static constexpr size_t MAX_BLOCK_SIZE = size_t{1} << MAX_CLASS_SHIFT;
+
+    // Наименьший класс размера, вмещающий bytes байт
+    static size_t ClassSize(size_t bytes) noexcept {
+        assert(bytes <= MAX_BLOCK_SIZE);
+        return size_t{1} << (ClassOf(bytes) + MIN_CLASS_SHIFT);
+    }
+
+    static void* Allocate(size_t bytes) {
+        if (bytes > MAX_BLOCK_SIZE) {
+            return ::operator new(bytes);
+        }
+
+        const size_t cls = ClassOf(bytes);
+
+        if (!cache_destroyed_) {
+            FreeList& list = Cache().lists[cls];
+            if (list.head == nullptr) {
+                Refill(cls, list);
+            }
+            if (list.head != nullptr) {
+                --list.count;
+                return std::exchange(list.head, list.head->next);
+            }
+        }
+
+        return ::operator new(size_t{1} << (cls + MIN_CLASS_SHIFT));
+    }
+
+    static void Deallocate(void* p, size_t bytes) noexcept {
+        if (bytes > MAX_BLOCK_SIZE) {
+            ::operator delete(p);
+            return;
+        }
+
+        const size_t cls = ClassOf(bytes);
+        Block* block = static_cast<Block*>(p);
+
+        if (cache_destroyed_) {
+            // Поток завершается, и его кэш уже уничтожен
+            block->next = nullptr;
+            PushBatch(cls, block);
+            return;
+        }
+
+        FreeList& list = Cache().lists[cls];
+        block->next = list.head;
+        list.head = block;
+
+        if (++list.count >= 2 * BatchSize(cls)) {
+            Block* last = list.head;
+            for (size_t i = 1; i < BatchSize(cls); ++i) {
+                last = last->next;
+            }
+            Block* batch = std::exchange(list.head, last->next);
+            last->next = nullptr;
+            list.count -= BatchSize(cls);
+            PushBatch(cls, batch);
+        }
+    }
+
+    // Возвращает системе блоки из общего хранилища. Кэши потоков не затрагиваются
+    static void Trim() noexcept {
+        Depot& depot = GetDepot();
+        std::lock_guard guard(depot.mutex);
+
+        for (Block*& batches : depot.batches) {
+            while (batches != nullptr) {
+                Block* batch = std::exchange(batches, batches->next_batch);
+                while (batch != nullptr) {
+                    ::operator delete(std::exchange(batch, batch->next));
+                }
+            }
+        }
+    }
+
+private:
+    struct Block {
+        Block* next;
+        Block* next_batch;  // используется только первым блоком пачки в хранилище
+    };
+
+    struct FreeList {
+        Block* head = nullptr;
+        size_t count = 0;
+    };
+
+    struct ThreadCache {
+        ~ThreadCache() {
+            cache_destroyed_ = true;
+            for (size_t cls = 0; cls < CLASS_COUNT; ++cls) {
+                if (lists[cls].head != nullptr) {
+                    PushBatch(cls, lists[cls].head);
+                }
+            }
+        }
+
+        FreeList lists[CLASS_COUNT];
+    };
+
+    struct Depot {
+        std::mutex mutex;
+        Block* batches[CLASS_COUNT] = {};
+    };
+
+    static size_t ClassOf(size_t bytes) noexcept {
+        size_t cls = 0;
+        while ((size_t{1} << (cls + MIN_CLASS_SHIFT)) < bytes) {
+            ++cls;
+        }
+        return cls;
+    }
+
+    // Пачка занимает около 64 КиБ, но содержит от 1 до 32 блоков
+    static size_t BatchSize(size_t cls) noexcept {
+        const size_t block_size = size_t{1} << (cls + MIN_CLASS_SHIFT);
+        return std::clamp<size_t>((64 * 1024) / block_size, 1, 32);
+    }
+
+    static ThreadCache& Cache() noexcept {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+
+    // Хранилище не уничтожается, чтобы кэши потоков могли сдать в него блоки
+    // даже после завершения main
+    static Depot& GetDepot() noexcept {
+        static Depot* depot = new Depot;
+        return *depot;
+    }
+
+    static void PushBatch(size_t cls, Block* batch) noexcept {
+        Depot& depot = GetDepot();
+        std::lock_guard guard(depot.mutex);
+        batch->next_batch = depot.batches[cls];
+        depot.batches[cls] = batch;
+    }
+
+    static void Refill(size_t cls, FreeList& list) noexcept {
+        Depot& depot = GetDepot();
+        {
+            std::lock_guard guard(depot.mutex);
+            list.head = depot.batches[cls];
+            if (list.head != nullptr) {
+                depot.batches[cls] = list.head->next_batch;
+            }
+        }
+
+        for (Block* block = list.head; block != nullptr; block = block->next) {
+            ++list.count;
+        }
+    }
+
+    inline static thread_local bool cache_destroyed_ = false;
+};
+
+template <typename T>
+struct PoolAllocator {
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Pool blocks only have the default new alignment");
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& /*other*/) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(Pool::Allocate(BytesFor(n)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        Pool::Deallocate(p, n * sizeof(T));
+    }
+
+    friend bool operator==(const PoolAllocator&, const PoolAllocator&) noexcept {
+        return true;
+    }
+
+    friend bool operator!=(const PoolAllocator&, const PoolAllocator&) noexcept {
+        return false;
+    }
+
+private:
+    static size_t BytesFor(size_t n) {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+};
+
+// Доводит ёмкость до целого класса размера пула, чтобы хвост блока не пропадал
+template <typename Base = DoublingGrowth>
+struct PoolGrowth {
+    static size_t NewCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t new_capacity = Base::NewCapacity(capacity, required, element_size);
+        if (new_capacity > Pool::MAX_BLOCK_SIZE / element_size) {
+            return new_capacity;
+        }
+        return Pool::ClassSize(new_capacity * element_size) / element_size;
+    }
+};
@@ -0,0 +1,392 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cstdint>
+#include <limits>
+
+// Векторизованные алгоритмы для векторов арифметических типов. Ядра написаны один раз
+// на векторных расширениях GCC и компилируются под несколько наборов инструкций;
+// нужный выбирается при первом вызове по возможностям процессора.
+// Особенности по сравнению с последовательными алгоритмами:
+// Sum складывает элементы в другом порядке, поэтому сумма float и double может
+// отличаться в последних битах; MinMax не определён для диапазонов с NaN
+enum class SimdIsa {
+    SCALAR,
+    SSE2,
+    AVX2,
+    AVX512,
+    NEON,
+};
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ADVANCED_VECTOR_SIMD_X86 1
+#elif defined(__GNUC__) && defined(__ARM_NEON)
+#define ADVANCED_VECTOR_SIMD_NEON 1
+#endif
+
+inline bool SimdIsaSupported(SimdIsa isa) noexcept {
+    switch (isa) {
+    case SimdIsa::SCALAR:
+        return true;
+#ifdef ADVANCED_VECTOR_SIMD_X86
+    case SimdIsa::SSE2:
+        return __builtin_cpu_supports("sse2");
+    case SimdIsa::AVX2:
+        return __builtin_cpu_supports("avx2");
+    case SimdIsa::AVX512:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+#ifdef ADVANCED_VECTOR_SIMD_NEON
+    case SimdIsa::NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+// Самый широкий набор инструкций, доступный на этом процессоре
+inline SimdIsa ActiveSimdIsa() noexcept {
+    static const SimdIsa isa = [] {
+        for (SimdIsa candidate : {SimdIsa::AVX512, SimdIsa::AVX2, SimdIsa::SSE2, SimdIsa::NEON}) {
+            if (SimdIsaSupported(candidate)) {
+                return candidate;
+            }
+        }
+        return SimdIsa::SCALAR;
+    }();
+    return isa;
+}
+
+template <typename T>
+struct IsSimdType
+    : std::bool_constant<std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && (sizeof(T) == 1 || sizeof(T) == 2
+                                                                                 || sizeof(T) == 4 || sizeof(T) == 8)> {};
+
+// Ядра для регистров шириной Bytes байт. Векторные типы не пересекают границы функций,
+// чтобы ядра можно было встраивать в обёртки с атрибутом target без смены ABI.
+// Основной цикл выравнивает указатель скалярным прологом: для буферов от
+// AlignedAllocator пролог пуст, и все загрузки выровнены
+template <size_t Bytes, typename T>
+struct SimdKernels {
+    static constexpr size_t LANES = Bytes / sizeof(T);
+
+    using Mask = std::conditional_t<sizeof(T) == 1, std::int8_t,
+                 std::conditional_t<sizeof(T) == 2, std::int16_t,
+                 std::conditional_t<sizeof(T) == 4, std::int32_t, std::int64_t>>>;
+
+    typedef T Vec __attribute__((vector_size(Bytes)));
+    typedef T UnalignedVec __attribute__((vector_size(Bytes), aligned(alignof(T))));
+
+    // Знаковые целые складываются как беззнаковые: переполнение заворачивается так же,
+    // как при последовательном сложении, но без неопределённого поведения
+    using SumType = typename std::conditional_t<std::is_integral_v<T> && std::is_signed_v<T>, std::make_unsigned<T>,
+                                       std::common_type<T>>::type;
+    typedef SumType SumVec __attribute__((vector_size(Bytes)));
+    typedef Mask MaskVec __attribute__((vector_size(Bytes)));
+
+    // Сколько первых элементов обработать скалярно, чтобы дойти до границы Bytes
+    static size_t Prologue(const T* p, size_t n) noexcept {
+        const size_t misalignment = reinterpret_cast<uintptr_t>(p) % Bytes;
+        if (misalignment % sizeof(T) != 0) {
+            return n;
+        }
+        return std::min(n, misalignment == 0 ? 0 : (Bytes - misalignment) / sizeof(T));
+    }
+
+    __attribute__((always_inline)) static void Fill(T* p, size_t n, T value) noexcept {
+        const size_t head = Prologue(p, n);
+        std::fill_n(p, head, value);
+
+        const Vec v = Vec{} + value;
+        size_t i = head;
+        for (; i + LANES <= n; i += LANES) {
+            *reinterpret_cast<Vec*>(p + i) = v;
+        }
+        std::fill(p + i, p + n, value);
+    }
+
+    __attribute__((always_inline)) static size_t Find(const T* p, size_t n, T value) noexcept {
+        const size_t head = Prologue(p, n);
+        for (size_t i = 0; i < head; ++i) {
+            if (p[i] == value) {
+                return i;
+            }
+        }
+
+        const Vec v = Vec{} + value;
+        size_t i = head;
+        for (; i + LANES <= n; i += LANES) {
+            const MaskVec equal = *reinterpret_cast<const Vec*>(p + i) == v;
+            if (AnyLane(equal)) {
+                break;
+            }
+        }
+        for (; i < n; ++i) {
+            if (p[i] == value) {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    __attribute__((always_inline)) static size_t Count(const T* p, size_t n, T value) noexcept {
+        const size_t head = Prologue(p, n);
+        size_t count = std::count(p, p + head, value);
+
+        // Счётчики в линиях шириной с T переполнились бы: сбрасываем их заранее
+        constexpr size_t FLUSH_EVERY = std::min<size_t>(size_t{1} << 20, std::numeric_limits<Mask>::max());
+        const Vec v = Vec{} + value;
+        size_t i = head;
+        while (i + LANES <= n) {
+            MaskVec lanes = MaskVec{};
+            for (size_t block = 0; block < FLUSH_EVERY && i + LANES <= n; ++block, i += LANES) {
+                lanes -= *reinterpret_cast<const Vec*>(p + i) == v;
+            }
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                count += static_cast<size_t>(lanes[lane]);
+            }
+        }
+        return count + std::count(p + i, p + n, value);
+    }
+
+    __attribute__((always_inline)) static std::pair<T, T> MinMax(const T* p, size_t n) noexcept {
+        assert(n != 0);
+        T min = p[0];
+        T max = p[0];
+
+        const size_t head = Prologue(p, n);
+        for (size_t i = 0; i < head; ++i) {
+            min = std::min(min, p[i]);
+            max = std::max(max, p[i]);
+        }
+
+        size_t i = head;
+        if (i + LANES <= n) {
+            Vec min_lanes = *reinterpret_cast<const Vec*>(p + i);
+            Vec max_lanes = min_lanes;
+            for (i += LANES; i + LANES <= n; i += LANES) {
+                const Vec x = *reinterpret_cast<const Vec*>(p + i);
+                min_lanes = x < min_lanes ? x : min_lanes;
+                max_lanes = x > max_lanes ? x : max_lanes;
+            }
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                min = std::min(min, min_lanes[lane]);
+                max = std::max(max, max_lanes[lane]);
+            }
+        }
+
+        for (; i < n; ++i) {
+            min = std::min(min, p[i]);
+            max = std::max(max, p[i]);
+        }
+        return {min, max};
+    }
+
+    __attribute__((always_inline)) static T Sum(const T* p, size_t n) noexcept {
+        const size_t head = Prologue(p, n);
+        SumType sum = SumType{};
+        for (size_t i = 0; i < head; ++i) {
+            sum += static_cast<SumType>(p[i]);
+        }
+
+        // Четыре независимых аккумулятора скрывают задержку сложения
+        SumVec acc[4] = {};
+        size_t i = head;
+        for (; i + 4 * LANES <= n; i += 4 * LANES) {
+            for (size_t k = 0; k < 4; ++k) {
+                acc[k] += reinterpret_cast<SumVec>(*reinterpret_cast<const Vec*>(p + i + k * LANES));
+            }
+        }
+        for (; i + LANES <= n; i += LANES) {
+            acc[0] += reinterpret_cast<SumVec>(*reinterpret_cast<const Vec*>(p + i));
+        }
+
+        const SumVec total = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            sum += total[lane];
+        }
+        for (; i < n; ++i) {
+            sum += static_cast<SumType>(p[i]);
+        }
+        return static_cast<T>(sum);
+    }
+
+    // Унарную функцию op вызывают и для векторов, и для отдельных элементов,
+    // поэтому она должна быть обобщённой, например [](auto x) { return x * 2 + 1; }
+    template <typename Op>
+    __attribute__((always_inline)) static void Transform(const T* in, size_t n, T* out, Op op) {
+        size_t i = 0;
+        for (; i + LANES <= n; i += LANES) {
+            const Vec x = *reinterpret_cast<const UnalignedVec*>(in + i);
+            *reinterpret_cast<UnalignedVec*>(out + i) = op(x);
+        }
+        for (; i < n; ++i) {
+            out[i] = op(in[i]);
+        }
+    }
+
+private:
+    __attribute__((always_inline)) static bool AnyLane(const MaskVec& mask) noexcept {
+        std::uint64_t words[Bytes / 8];
+        std::memcpy(words, &mask, Bytes);
+        std::uint64_t any = 0;
+        for (std::uint64_t word : words) {
+            any |= word;
+        }
+        return any != 0;
+    }
+};
+
+// Обёртки компилируют ядра под конкретный набор инструкций
+#ifdef ADVANCED_VECTOR_SIMD_X86
+#define ADVANCED_VECTOR_SIMD_TARGET(NAME, TARGET, BYTES)                                          \
+    struct NAME {                                                                                 \
+        template <typename T>                                                                     \
+        __attribute__((target(TARGET))) static void Fill(T* p, size_t n, T value) noexcept {      \
+            SimdKernels<BYTES, T>::Fill(p, n, value);                                             \
+        }                                                                                         \
+        template <typename T>                                                                     \
+        __attribute__((target(TARGET))) static size_t Find(const T* p, size_t n, T value) noexcept { \
+            return SimdKernels<BYTES, T>::Find(p, n, value);                                      \
+        }                                                                                         \
+        template <typename T>                                                                     \
+        __attribute__((target(TARGET))) static size_t Count(const T* p, size_t n, T value) noexcept { \
+            return SimdKernels<BYTES, T>::Count(p, n, value);                                     \
+        }                                                                                         \
+        template <typename T>                                                                     \
+        __attribute__((target(TARGET))) static std::pair<T, T> MinMax(const T* p, size_t n) noexcept { \
+            return SimdKernels<BYTES, T>::MinMax(p, n);                                           \
+        }                                                                                         \
+        template <typename T>                                                                     \
+        __attribute__((target(TARGET))) static T Sum(const T* p, size_t n) noexcept {             \
+            return SimdKernels<BYTES, T>::Sum(p, n);                                              \
+        }                                                                                         \
+    };
+
+ADVANCED_VECTOR_SIMD_TARGET(SimdSse2, "sse2", 16)
+ADVANCED_VECTOR_SIMD_TARGET(SimdAvx2, "avx2", 32)
+ADVANCED_VECTOR_SIMD_TARGET(SimdAvx512, "avx512f,avx512bw", 64)
+
+#undef ADVANCED_VECTOR_SIMD_TARGET
+
+#define ADVANCED_VECTOR_SIMD_DISPATCH(ISA, CALL)   \
+    switch (ISA) {                                 \
+    case SimdIsa::AVX512:                          \
+        return SimdAvx512::CALL;                   \
+    case SimdIsa::AVX2:                            \
+        return SimdAvx2::CALL;                     \
+    case SimdIsa::SSE2:                            \
+        return SimdSse2::CALL;                     \
+    default:                                       \
+        break;                                     \
+    }
+
+#elif defined(ADVANCED_VECTOR_SIMD_NEON)
+// NEON входит в базовый набор AArch64, поэтому обёртка не нужна
+#define ADVANCED_VECTOR_SIMD_DISPATCH(ISA, CALL)   \
+    if ((ISA) == SimdIsa::NEON) {                  \
+        return SimdKernels<16, T>::CALL;           \
+    }
+
+#else
+#define ADVANCED_VECTOR_SIMD_DISPATCH(ISA, CALL)
+#endif
+
+// Алгоритмы над сырыми диапазонами. isa позволяет выбрать набор инструкций явно,
+// по умолчанию используется ActiveSimdIsa(). Неподдерживаемый набор приводит к
+// неопределённому поведению, поэтому выбирать стоит только из SimdIsaSupported
+template <typename T>
+void SimdFill(T* p, size_t n, T value, SimdIsa isa = ActiveSimdIsa()) noexcept {
+    static_assert(IsSimdType<T>::value);
+    ADVANCED_VECTOR_SIMD_DISPATCH(isa, Fill(p, n, value))
+    std::fill_n(p, n, value);
+}
+
+template <typename T>
+size_t SimdFind(const T* p, size_t n, T value, SimdIsa isa = ActiveSimdIsa()) noexcept {
+    static_assert(IsSimdType<T>::value);
+    ADVANCED_VECTOR_SIMD_DISPATCH(isa, Find(p, n, value))
+    return std::find(p, p + n, value) - p;
+}
+
+template <typename T>
+size_t SimdCount(const T* p, size_t n, T value, SimdIsa isa = ActiveSimdIsa()) noexcept {
+    static_assert(IsSimdType<T>::value);
+    ADVANCED_VECTOR_SIMD_DISPATCH(isa, Count(p, n, value))
+    return std::count(p, p + n, value);
+}
+
+template <typename T>
+std::pair<T, T> SimdMinMax(const T* p, size_t n, SimdIsa isa = ActiveSimdIsa()) noexcept {
+    static_assert(IsSimdType<T>::value);
+    assert(n != 0);
+    ADVANCED_VECTOR_SIMD_DISPATCH(isa, MinMax(p, n))
+    const auto [min, max] = std::minmax_element(p, p + n);
+    return {*min, *max};
+}
+
+template <typename T>
+T SimdSum(const T* p, size_t n, SimdIsa isa = ActiveSimdIsa()) noexcept {
+    static_assert(IsSimdType<T>::value);
+    ADVANCED_VECTOR_SIMD_DISPATCH(isa, Sum(p, n))
+    using SumType = typename SimdKernels<16, T>::SumType;
+    SumType sum = SumType{};
+    for (size_t i = 0; i < n; ++i) {
+        sum += static_cast<SumType>(p[i]);
+    }
+    return static_cast<T>(sum);
+}
+
+#undef ADVANCED_VECTOR_SIMD_DISPATCH
+
+// op встраивается в вызывающий код, поэтому Transform не переключается между наборами
+// инструкций и использует 16-байтные регистры базового набора (SSE2 или NEON)
+template <typename T, typename Op>
+void SimdTransform(const T* in, size_t n, T* out, Op op) {
+    static_assert(IsSimdType<T>::value);
+#if defined(ADVANCED_VECTOR_SIMD_X86) && defined(__SSE2__) || defined(ADVANCED_VECTOR_SIMD_NEON)
+    SimdKernels<16, T>::Transform(in, n, out, op);
+#else
+    std::transform(in, in + n, out, op);
+#endif
+}
+
+// Те же алгоритмы для векторов
+template <typename T, typename... Policies>
+void Fill(Vector<T, Policies...>& v, typename Vector<T, Policies...>::value_type value) noexcept {
+    SimdFill(v.begin(), v.Size(), value);
+}
+
+template <typename T, typename... Policies>
+const T* Find(const Vector<T, Policies...>& v, typename Vector<T, Policies...>::value_type value) noexcept {
+    return v.begin() + SimdFind(v.begin(), v.Size(), value);
+}
+
+template <typename T, typename... Policies>
+size_t Count(const Vector<T, Policies...>& v, typename Vector<T, Policies...>::value_type value) noexcept {
+    return SimdCount(v.begin(), v.Size(), value);
+}
+
+template <typename T, typename... Policies>
+std::pair<T, T> MinMax(const Vector<T, Policies...>& v) noexcept {
+    return SimdMinMax(v.begin(), v.Size());
+}
+
+template <typename T, typename... Policies>
+T Sum(const Vector<T, Policies...>& v) noexcept {
+    return SimdSum(v.begin(), v.Size());
+}
+
+// Записывает op(x) для каждого элемента in в out, меняя размер out под in
+template <typename T, typename... Policies, typename Op>
+void Transform(const Vector<T, Policies...>& in, Vector<T, Policies...>& out, Op op) {
+    if (&in != &out) {
+        out.ResizeDefaultInit(in.Size());
+    }
+    SimdTransform(in.begin(), in.Size(), out.begin(), op);
+}
+
+#undef ADVANCED_VECTOR_SIMD_X86
+#undef ADVANCED_VECTOR_SIMD_NEON
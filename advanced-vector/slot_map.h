@@ -0,0 +1,226 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+// Ключ элемента SlotMap. Остаётся действительным, пока элемент не удалён;
+// после удаления поколение слота меняется, и старый ключ больше ничего не находит
+struct SlotHandle {
+    static constexpr uint32_t NO_INDEX = std::numeric_limits<uint32_t>::max();
+
+    uint32_t index = NO_INDEX;
+    uint32_t generation = 0;
+
+    friend bool operator==(const SlotHandle& lhs, const SlotHandle& rhs) noexcept {
+        return lhs.index == rhs.index && lhs.generation == rhs.generation;
+    }
+
+    friend bool operator!=(const SlotHandle& lhs, const SlotHandle& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+};
+
+// Контейнер с вставкой и удалением за O(1) и стабильными ключами.
+// Элементы лежат плотно в одном Vector в произвольном порядке, поэтому обход
+// идёт по непрерывной памяти. Удаление переносит последний элемент на место
+// удалённого, а таблица слотов переводит ключи в текущие позиции элементов.
+// Нечётное поколение слота означает, что он занят. Поколение 32-битное:
+// ключ, пролежавший 2^31 переиспользований своего слота, снова станет действительным
+template <typename T, typename Alloc = std::allocator<T>>
+class SlotMap {
+    using SlotAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<uint32_t>;
+
+    struct Slot {
+        // Позиция элемента, если слот занят, иначе следующий свободный слот
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    using SlotVectorAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Slot>;
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SlotMap() = default;
+
+    explicit SlotMap(const Alloc& alloc)
+        : values_(alloc)
+        , owners_(SlotAlloc(alloc))
+        , slots_(SlotVectorAlloc(alloc))
+    {}
+
+    iterator begin() noexcept {
+        return values_.begin();
+    }
+
+    iterator end() noexcept {
+        return values_.end();
+    }
+
+    const_iterator begin() const noexcept {
+        return values_.begin();
+    }
+
+    const_iterator end() const noexcept {
+        return values_.end();
+    }
+
+    size_t Size() const noexcept {
+        return values_.Size();
+    }
+
+    bool Empty() const noexcept {
+        return values_.Size() == 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return values_.Capacity();
+    }
+
+    T* Data() noexcept {
+        return values_.begin();
+    }
+
+    const T* Data() const noexcept {
+        return values_.begin();
+    }
+
+    void Reserve(size_t new_capacity) {
+        CheckCapacity(new_capacity);
+        values_.Reserve(new_capacity);
+        owners_.Reserve(new_capacity);
+        slots_.Reserve(new_capacity);
+    }
+
+    // Строгая гарантия: вся память выделяется до конструирования элемента,
+    // а после него ничего не бросает
+    template <typename... Args>
+    SlotHandle Emplace(Args&&... args) {
+        const size_t position = values_.Size();
+        CheckCapacity(position + 1);
+
+        owners_.Reserve(NextCapacity(owners_, position + 1));
+        if (free_head_ == SlotHandle::NO_INDEX) {
+            slots_.Reserve(NextCapacity(slots_, slots_.Size() + 1));
+        }
+
+        values_.EmplaceBack(std::forward<Args>(args)...);
+
+        uint32_t slot_index = free_head_;
+        if (slot_index == SlotHandle::NO_INDEX) {
+            slot_index = static_cast<uint32_t>(slots_.Size());
+            slots_.PushBack(Slot{0, 0});
+        } else {
+            free_head_ = slots_[slot_index].index;
+        }
+
+        Slot& slot = slots_[slot_index];
+        slot.index = static_cast<uint32_t>(position);
+        ++slot.generation;
+        owners_.PushBack(slot_index);
+
+        return SlotHandle{slot_index, slot.generation};
+    }
+
+    template <typename Value>
+    SlotHandle Insert(Value&& value) {
+        return Emplace(std::forward<Value>(value));
+    }
+
+    bool Contains(SlotHandle handle) const noexcept {
+        return handle.index < slots_.Size() && slots_[handle.index].generation == handle.generation
+               && (handle.generation & 1) != 0;
+    }
+
+    // Элемент по ключу или nullptr, если он уже удалён
+    T* Find(SlotHandle handle) noexcept {
+        return Contains(handle) ? values_.begin() + slots_[handle.index].index : nullptr;
+    }
+
+    const T* Find(SlotHandle handle) const noexcept {
+        return const_cast<SlotMap&>(*this).Find(handle);
+    }
+
+    T& operator[](SlotHandle handle) noexcept {
+        assert(Contains(handle));
+        return values_[slots_[handle.index].index];
+    }
+
+    const T& operator[](SlotHandle handle) const noexcept {
+        return const_cast<SlotMap&>(*this)[handle];
+    }
+
+    // Ключ элемента, стоящего на позиции position при обходе
+    SlotHandle HandleAt(size_t position) const noexcept {
+        assert(position < values_.Size());
+        const uint32_t slot_index = owners_[position];
+        return SlotHandle{slot_index, slots_[slot_index].generation};
+    }
+
+    // Удаляет элемент и возвращает false, если ключ недействителен.
+    // Гарантия базовая, как у Vector::SwapErase: перемещающее присваивание может бросить
+    bool Erase(SlotHandle handle) {
+        if (!Contains(handle)) {
+            return false;
+        }
+
+        Slot& slot = slots_[handle.index];
+        const uint32_t position = slot.index;
+
+        values_.SwapErase(values_.begin() + position);
+        owners_.SwapErase(owners_.begin() + position);
+        if (position < owners_.Size()) {
+            slots_[owners_[position]].index = position;
+        }
+
+        ++slot.generation;
+        slot.index = free_head_;
+        free_head_ = handle.index;
+        return true;
+    }
+
+    // Удаляет все элементы. Выданные ранее ключи становятся недействительными
+    void Clear() noexcept {
+        for (uint32_t slot_index : owners_) {
+            Slot& slot = slots_[slot_index];
+            ++slot.generation;
+            slot.index = free_head_;
+            free_head_ = slot_index;
+        }
+        values_.Clear();
+        owners_.Clear();
+    }
+
+    void Swap(SlotMap& other) noexcept {
+        values_.Swap(other.values_);
+        owners_.Swap(other.owners_);
+        slots_.Swap(other.slots_);
+        std::swap(free_head_, other.free_head_);
+    }
+
+private:
+    static void CheckCapacity(size_t capacity) {
+        if (capacity >= SlotHandle::NO_INDEX) {
+            throw std::length_error("SlotMap cannot hold that many elements");
+        }
+    }
+
+    // Рост служебных векторов по той же политике, что у элементов
+    template <typename V>
+    static size_t NextCapacity(const V& v, size_t required) noexcept {
+        return required <= v.Capacity() ? required
+                                        : V::growth_policy::NewCapacity(v.Capacity(), required,
+                                                                        sizeof(typename V::value_type));
+    }
+
+    Vector<T, Alloc> values_;
+    // Слот каждого элемента, по позициям values_
+    Vector<uint32_t, SlotAlloc> owners_;
+    Vector<Slot, SlotVectorAlloc> slots_;
+    uint32_t free_head_ = SlotHandle::NO_INDEX;
+};
@@ -0,0 +1,315 @@
+#pragma once
+
+#include "vector.h"
+
+// Вектор, хранящий до N элементов внутри себя. Куча используется только тогда,
+// когда элементы перестают помещаться во встроенный буфер
+template <typename T, size_t N, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+class SmallVector {
+    static_assert(N > 0, "SmallVector needs a non-empty inline buffer");
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    iterator begin() noexcept {
+        return data_;
+    }
+
+    iterator end() noexcept {
+        return data_ + size_;
+    }
+
+    const_iterator begin() const noexcept {
+        return data_;
+    }
+    const_iterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    const_iterator cbegin() const noexcept {
+        return data_;
+    }
+    const_iterator cend() const noexcept {
+        return data_ + size_;
+    }
+
+
+    SmallVector() = default;
+
+    explicit SmallVector(const Alloc& alloc) noexcept
+        : heap_(alloc)
+    {}
+
+    explicit SmallVector(size_t size, const Alloc& alloc = Alloc())
+        : heap_(alloc)
+    {
+        Reserve(size);
+        std::uninitialized_value_construct_n(data_, size);
+        size_ = size;
+    }
+
+    SmallVector(const SmallVector& other)
+        : heap_(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.heap_.GetAllocator()))
+    {
+        Reserve(other.size_);
+        std::uninitialized_copy_n(other.data_, other.size_, data_);
+        size_ = other.size_;
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : heap_(std::move(other.heap_))
+    {
+        if (!other.IsInline()) {
+            data_ = heap_.GetAddress();
+            other.data_ = other.InlineData();
+        } else {
+            UninitializedRelocate(other.data_, other.size_, data_, other.size_, 0);
+        }
+
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    SmallVector& operator=(const SmallVector& rhs) {
+        if (this != &rhs) {
+            if (rhs.size_ > Capacity()) {
+                SmallVector rhs_copy(rhs);
+                Swap(rhs_copy);
+
+            } else {
+                size_t min = std::min(size_, rhs.size_);
+                std::copy_n(rhs.data_, min, data_);
+
+                if (size_ >= rhs.size_) {
+                    std::destroy_n(data_ + rhs.size_, size_ - rhs.size_);
+                } else {
+                    std::uninitialized_copy_n(rhs.data_ + size_, rhs.size_ - size_, data_ + size_);
+                }
+
+                size_ = rhs.size_;
+            }
+        }
+
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>
+                                                       && std::is_nothrow_move_assignable_v<T>) {
+        if (this != &rhs) {
+            if (!rhs.IsInline()) {
+                std::destroy_n(data_, size_);
+                heap_ = std::move(rhs.heap_);
+                data_ = heap_.GetAddress();
+                size_ = std::exchange(rhs.size_, 0);
+                rhs.data_ = rhs.InlineData();
+
+            } else {
+                // Элементы rhs помещаются во встроенный буфер, а значит, и в наш
+                size_t min = std::min(size_, rhs.size_);
+                std::move(rhs.data_, rhs.data_ + min, data_);
+
+                if (size_ >= rhs.size_) {
+                    std::destroy_n(data_ + rhs.size_, size_ - rhs.size_);
+                } else {
+                    std::uninitialized_move_n(rhs.data_ + size_, rhs.size_ - size_, data_ + size_);
+                }
+
+                size_ = rhs.size_;
+                rhs.Clear();
+            }
+        }
+
+        return *this;
+    }
+
+    void Swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>
+                                           && std::is_nothrow_move_assignable_v<T>) {
+        if (this == &other) {
+            return;
+        }
+
+        if (!IsInline() && !other.IsInline()) {
+            heap_.Swap(other.heap_);
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            return;
+        }
+
+        SmallVector temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+
+    ~SmallVector() {
+        std::destroy_n(data_, size_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return IsInline() ? N : heap_.Capacity();
+    }
+
+    static constexpr size_t InlineCapacity() noexcept {
+        return N;
+    }
+
+    bool IsInline() const noexcept {
+        return data_ == InlineData();
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SmallVector&>(*this)[index];
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+
+        RawMemory<T, Alloc> new_heap(new_capacity, heap_.GetAllocator());
+        UninitializedRelocate(data_, size_, new_heap.GetAddress(), size_, 0);
+        AdoptHeap(new_heap);
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size <= size_) {
+            std::destroy_n(data_ + new_size, size_ - new_size);
+        } else {
+            Reserve(new_size);
+            std::uninitialized_value_construct_n(data_ + size_, new_size - size_);
+        }
+
+        size_ = new_size;
+    }
+
+    void Clear() noexcept {
+        std::destroy_n(data_, size_);
+        size_ = 0;
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            InsertAndReallocate(size_, std::forward<Args>(args)...);
+        } else {
+            new (data_ + size_) T(std::forward<Args>(args)...);
+        }
+
+        return data_[size_++];
+    }
+
+    template <typename Value>
+    void PushBack(Value&& value) {
+        EmplaceBack(std::forward<Value>(value));
+    }
+
+    void PopBack() {
+        assert(size_ != 0);
+        std::destroy_at(data_ + size_ - 1);
+        --size_;
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        assert(pos >= cbegin() && pos <= cend());
+
+        size_t offset = pos - cbegin();
+
+        if (size_ == Capacity()) {
+            InsertAndReallocate(offset, std::forward<Args>(args)...);
+        } else {
+            InsertWithoutReallocating(offset, std::forward<Args>(args)...);
+        }
+
+        ++size_;
+
+        return begin() + offset;
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    iterator Erase(const_iterator pos) {
+        assert(pos >= cbegin() && pos < cend());
+
+        size_t offset = pos - cbegin();
+
+        std::move(begin() + offset + 1, end(), begin() + offset);
+        std::destroy_at(end() - 1);
+        --size_;
+
+        return begin() + offset;
+    }
+
+private:
+    T* InlineData() noexcept {
+        return reinterpret_cast<T*>(inline_);
+    }
+
+    const T* InlineData() const noexcept {
+        return reinterpret_cast<const T*>(inline_);
+    }
+
+    // Элементы уже перенесены в new_heap; старый буфер в куче освобождается вместе с new_heap
+    void AdoptHeap(RawMemory<T, Alloc>& new_heap) noexcept {
+        heap_.Swap(new_heap);
+        data_ = heap_.GetAddress();
+    }
+
+    template <typename... Args>
+    void InsertAndReallocate(size_t offset, Args&&... args) {
+        RawMemory<T, Alloc> new_heap(Growth::NewCapacity(Capacity(), size_ + 1, sizeof(T)),
+                                     heap_.GetAllocator());
+        new (new_heap.GetAddress() + offset) T(std::forward<Args>(args)...);
+
+        try {
+            UninitializedRelocate(data_, size_, new_heap.GetAddress(), offset, 1);
+        } catch (...) {
+            std::destroy_at(new_heap.GetAddress() + offset);
+            throw;
+        }
+
+        AdoptHeap(new_heap);
+    }
+
+    template <typename... Args>
+    void InsertWithoutReallocating(size_t offset, Args&&... args) {
+        if (offset != size_) {
+            T temp(std::forward<Args>(args)...);
+            new (end()) T(std::move(data_[size_ - 1]));
+
+            // Элемент за концом ещё не входит в size_, поэтому при исключении
+            // во время сдвига его нужно уничтожить здесь
+            try {
+                std::move_backward(begin() + offset, end() - 1, end());
+                data_[offset] = std::move(temp);
+            } catch (...) {
+                std::destroy_at(end());
+                throw;
+            }
+
+        } else {
+            new (end()) T(std::forward<Args>(args)...);
+        }
+    }
+
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+    RawMemory<T, Alloc> heap_;
+    T* data_ = InlineData();
+    size_t size_ = 0;
+};
@@ -0,0 +1,515 @@
+#pragma once
+
+#include "vector.h"
+
+#include <stdexcept>
+#include <tuple>
+
+// Вектор строк из полей Ts..., где каждое поле хранится в своём столбце RawMemory.
+// Все столбцы растут вместе и имеют одну ёмкость. Цикл по одному столбцу читает
+// только его байты, а строки доступны через кортежи ссылок.
+// Столбцы выделяются копиями Alloc, перепривязанными к типу столбца. Growth получает
+// размер строки целиком, и, как у Vector, ShrinkCapacity включает уменьшение при удалении.
+// Гарантии исключений те же, что у Vector: EmplaceBack, Reserve и Resize строгие,
+// Erase базовая
+template <typename Alloc, typename Growth, typename... Ts>
+class BasicSoaVector {
+    static_assert(sizeof...(Ts) > 0, "SoaVector needs at least one column");
+
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    template <size_t I>
+    using ColumnType = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    template <typename U>
+    using ColumnStorage = RawMemory<U, typename AllocTraits::template rebind_alloc<U>>;
+
+    static constexpr size_t ROW_SIZE = (sizeof(Ts) + ...);
+
+    using Indices = std::index_sequence_for<Ts...>;
+
+    // Столбцы, перенос которых не может бросить исключение, переносятся после
+    // остальных, поэтому при неудаче их возвращать не придётся
+    template <typename U>
+    static constexpr bool RELOCATES_NOTHROW =
+        IsTriviallyRelocatable<U>::value || std::is_nothrow_move_constructible_v<U>;
+
+public:
+    using allocator_type = Alloc;
+    using Row = std::tuple<Ts&...>;
+    using ConstRow = std::tuple<const Ts&...>;
+
+    template <bool IsConst>
+    class BasicIterator {
+        using Owner = std::conditional_t<IsConst, const BasicSoaVector, BasicSoaVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::tuple<Ts...>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IsConst, ConstRow, Row>;
+        using pointer = void;
+
+        BasicIterator() = default;
+
+        BasicIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index)
+        {}
+
+        operator BasicIterator<true>() const noexcept {
+            return BasicIterator<true>(owner_, index_);
+        }
+
+        reference operator*() const noexcept {
+            return (*owner_)[index_];
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return (*owner_)[index_ + offset];
+        }
+
+        size_t Index() const noexcept {
+            return index_;
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            return BasicIterator(owner_, index_++);
+        }
+
+        BasicIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            return BasicIterator(owner_, index_--);
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ <= rhs.index_;
+        }
+
+        friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ > rhs.index_;
+        }
+
+        friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ >= rhs.index_;
+        }
+
+    private:
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+
+    BasicSoaVector() = default;
+
+    explicit BasicSoaVector(const Alloc& alloc) noexcept
+        : columns_(ColumnStorage<Ts>(typename AllocTraits::template rebind_alloc<Ts>(alloc))...)
+    {}
+
+    explicit BasicSoaVector(size_t size, const Alloc& alloc = Alloc())
+        : BasicSoaVector(alloc)
+    {
+        Resize(size);
+    }
+
+    BasicSoaVector(const BasicSoaVector& other)
+        : BasicSoaVector(AllocTraits::select_on_container_copy_construction(other.GetAllocator()))
+    {
+        Reserve(other.size_);
+        CopyColumns(other, Indices{});
+        size_ = other.size_;
+    }
+
+    BasicSoaVector(BasicSoaVector&& other) noexcept
+        : columns_(std::move(other.columns_))
+        , size_(std::exchange(other.size_, 0))
+    {}
+
+    BasicSoaVector& operator=(const BasicSoaVector& rhs) {
+        if (this != &rhs) {
+            BasicSoaVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    BasicSoaVector& operator=(BasicSoaVector&& rhs) noexcept {
+        if (this != &rhs) {
+            BasicSoaVector rhs_copy(std::move(rhs));
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    ~BasicSoaVector() {
+        DestroyRows(0, size_, Indices{});
+    }
+
+    Alloc GetAllocator() const noexcept {
+        return Alloc(std::get<0>(columns_).GetAllocator());
+    }
+
+    void Swap(BasicSoaVector& other) noexcept {
+        SwapColumns(other, Indices{});
+        std::swap(size_, other.size_);
+    }
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+
+    iterator end() noexcept {
+        return iterator(this, size_);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this, size_);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return std::get<0>(columns_).Capacity();
+    }
+
+    Row operator[](size_t index) noexcept {
+        assert(index < size_);
+        return RowAt(index, Indices{});
+    }
+
+    ConstRow operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return RowAt(index, Indices{});
+    }
+
+    template <size_t I>
+    ColumnType<I>* Data() noexcept {
+        return std::get<I>(columns_).GetAddress();
+    }
+
+    template <size_t I>
+    const ColumnType<I>* Data() const noexcept {
+        return std::get<I>(columns_).GetAddress();
+    }
+
+#ifdef __cpp_lib_span
+    template <size_t I>
+    std::span<ColumnType<I>> Column() noexcept {
+        return std::span<ColumnType<I>>(Data<I>(), size_);
+    }
+
+    template <size_t I>
+    std::span<const ColumnType<I>> Column() const noexcept {
+        return std::span<const ColumnType<I>>(Data<I>(), size_);
+    }
+#endif
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > Capacity()) {
+            // Пустой конструктор строки: перенос без зазора под новую строку
+            Reallocate(new_capacity, size_, 0, [](Storage& /*storage*/, size_t /*index*/) {});
+        }
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size <= size_) {
+            DestroyRows(new_size, size_, Indices{});
+        } else {
+            Reserve(new_size);
+            ConstructColumns(size_, new_size, Indices{});
+        }
+        size_ = new_size;
+        MaybeShrink();
+    }
+
+    void Clear() noexcept {
+        DestroyRows(0, size_, Indices{});
+        size_ = 0;
+        MaybeShrink();
+    }
+
+    // Принимает по одному значению на столбец
+    template <typename... Values>
+    Row EmplaceBack(Values&&... values) {
+        static_assert(sizeof...(Values) == sizeof...(Ts), "EmplaceBack takes one value per column");
+
+        if (size_ == Capacity()) {
+            // Строка конструируется в новом буфере до переноса старых, поэтому
+            // значения могут ссылаться на элементы этого же вектора
+            Reallocate(NextCapacity(), size_, 1, [&](Storage& storage, size_t index) {
+                ConstructRow(storage, index, Indices{}, std::forward<Values>(values)...);
+            });
+        } else {
+            ConstructRow(columns_, size_, Indices{}, std::forward<Values>(values)...);
+        }
+
+        ++size_;
+        return (*this)[size_ - 1];
+    }
+
+    void PushBack(const Ts&... values) {
+        EmplaceBack(values...);
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        DestroyRows(size_ - 1, size_, Indices{});
+        --size_;
+        MaybeShrink();
+    }
+
+    iterator Erase(const_iterator pos) {
+        assert(pos.Index() < size_);
+
+        const size_t index = pos.Index();
+        EraseColumns(index, Indices{});
+        PopBack();
+        return iterator(this, index);
+    }
+
+private:
+    using Storage = std::tuple<ColumnStorage<Ts>...>;
+
+    size_t NextCapacity() const noexcept {
+        return Growth::NewCapacity(Capacity(), size_ + 1, ROW_SIZE);
+    }
+
+    // Неудачная реаллокация оставляет буферы как есть, см. Vector::MaybeShrink
+    void MaybeShrink() noexcept {
+        if constexpr (HasShrinkCapacity<Growth>::value) {
+            const size_t new_capacity = Growth::ShrinkCapacity(Capacity(), size_, ROW_SIZE);
+            if (new_capacity < Capacity()) {
+                try {
+                    Reallocate(new_capacity, size_, 0, [](Storage& /*storage*/, size_t /*index*/) {});
+                } catch (...) {
+                }
+            }
+        }
+    }
+
+    template <size_t... I>
+    Row RowAt(size_t index, std::index_sequence<I...>) noexcept {
+        return Row(std::get<I>(columns_)[index]...);
+    }
+
+    template <size_t... I>
+    ConstRow RowAt(size_t index, std::index_sequence<I...>) const noexcept {
+        return ConstRow(std::get<I>(columns_)[index]...);
+    }
+
+    // Конструирует элементы строки index в storage. Если конструктор столбца бросает
+    // исключение, уже созданные элементы этой строки уничтожаются
+    template <size_t... I, typename... Values>
+    static void ConstructRow(Storage& storage, size_t index, std::index_sequence<I...>, Values&&... values) {
+        size_t constructed = 0;
+        try {
+            ((new (std::get<I>(storage) + index) Ts(std::forward<Values>(values)), ++constructed), ...);
+        } catch (...) {
+            ((I < constructed ? std::destroy_at(std::get<I>(storage) + index) : void()), ...);
+            throw;
+        }
+    }
+
+    // Переносит строки в буферы ёмкостью new_capacity, оставляя gap свободных строк
+    // начиная с offset, в которых construct_gap создаёт новые элементы. Сначала
+    // копируются столбцы, перенос которых может бросить исключение: исходные
+    // элементы при этом остаются на месте. Затем переносятся остальные столбцы,
+    // что уже не может завершиться неудачей
+    template <typename ConstructGap>
+    void Reallocate(size_t new_capacity, size_t offset, size_t gap, ConstructGap construct_gap) {
+        Storage storage(MakeStorage(new_capacity, Indices{}));
+        construct_gap(storage, offset);
+
+        try {
+            CopyThrowingColumns(storage, offset, gap, Indices{});
+        } catch (...) {
+            DestroyGap(storage, offset, gap, Indices{});
+            throw;
+        }
+
+        RelocateNothrowColumns(storage, offset, gap, Indices{});
+        columns_.swap(storage);
+    }
+
+    template <size_t... I>
+    Storage MakeStorage(size_t capacity, std::index_sequence<I...>) const {
+        return Storage(ColumnStorage<Ts>(capacity, std::get<I>(columns_).GetAllocator())...);
+    }
+
+    template <size_t... I>
+    void CopyThrowingColumns(Storage& storage, size_t offset, size_t gap, std::index_sequence<I...>) {
+        size_t copied = 0;
+        try {
+            ((CopyThrowingColumn<I>(storage, offset, gap), ++copied), ...);
+        } catch (...) {
+            ((I < copied && !RELOCATES_NOTHROW<Ts> ? DestroyColumnCopy<I>(storage, offset, gap) : void()), ...);
+            throw;
+        }
+        // Исходные элементы больше не нужны
+        ((!RELOCATES_NOTHROW<Ts> ? (void)std::destroy_n(std::get<I>(columns_).GetAddress(), size_) : void()), ...);
+    }
+
+    template <size_t I>
+    void CopyThrowingColumn(Storage& storage, size_t offset, size_t gap) {
+        using U = ColumnType<I>;
+        if constexpr (!RELOCATES_NOTHROW<U>) {
+            U* from = std::get<I>(columns_).GetAddress();
+            U* to = std::get<I>(storage).GetAddress();
+
+            if constexpr (std::is_copy_constructible_v<U>) {
+                std::uninitialized_copy_n(from, offset, to);
+                try {
+                    std::uninitialized_copy_n(from + offset, size_ - offset, to + offset + gap);
+                } catch (...) {
+                    std::destroy_n(to, offset);
+                    throw;
+                }
+            } else {
+                std::uninitialized_move_n(from, offset, to);
+                try {
+                    std::uninitialized_move_n(from + offset, size_ - offset, to + offset + gap);
+                } catch (...) {
+                    std::destroy_n(to, offset);
+                    throw;
+                }
+            }
+        }
+    }
+
+    template <size_t I>
+    void DestroyColumnCopy(Storage& storage, size_t offset, size_t gap) noexcept {
+        ColumnType<I>* to = std::get<I>(storage).GetAddress();
+        std::destroy_n(to, offset);
+        std::destroy_n(to + offset + gap, size_ - offset);
+    }
+
+    template <size_t... I>
+    void RelocateNothrowColumns(Storage& storage, size_t offset, size_t gap, std::index_sequence<I...>) noexcept {
+        ((RELOCATES_NOTHROW<Ts>
+              ? UninitializedRelocate(std::get<I>(columns_).GetAddress(), size_, std::get<I>(storage).GetAddress(),
+                                      offset, gap)
+              : void()),
+         ...);
+    }
+
+    template <size_t... I>
+    static void DestroyGap(Storage& storage, size_t offset, size_t gap, std::index_sequence<I...>) noexcept {
+        (std::destroy_n(std::get<I>(storage).GetAddress() + offset, gap), ...);
+    }
+
+    // Конструирует элементы [from, to) во всех столбцах со строгой гарантией
+    template <size_t... I>
+    void ConstructColumns(size_t from, size_t to, std::index_sequence<I...>) {
+        size_t constructed = 0;
+        try {
+            ((std::uninitialized_value_construct(std::get<I>(columns_) + from, std::get<I>(columns_) + to),
+              ++constructed),
+             ...);
+        } catch (...) {
+            ((I < constructed ? std::destroy(std::get<I>(columns_) + from, std::get<I>(columns_) + to) : void()), ...);
+            throw;
+        }
+    }
+
+    template <size_t... I>
+    void CopyColumns(const BasicSoaVector& other, std::index_sequence<I...>) {
+        size_t copied = 0;
+        try {
+            ((std::uninitialized_copy_n(std::get<I>(other.columns_).GetAddress(), other.size_,
+                                        std::get<I>(columns_).GetAddress()),
+              ++copied),
+             ...);
+        } catch (...) {
+            ((I < copied ? (void)std::destroy_n(std::get<I>(columns_).GetAddress(), other.size_) : void()), ...);
+            throw;
+        }
+    }
+
+    template <size_t... I>
+    void DestroyRows(size_t from, size_t to, std::index_sequence<I...>) noexcept {
+        (std::destroy(std::get<I>(columns_) + from, std::get<I>(columns_) + to), ...);
+    }
+
+    // Сдвигает хвост всех столбцов на строку index. Последняя строка уничтожается
+    // только после сдвига всех столбцов: если присваивание бросит исключение,
+    // все size_ строк остаются живыми
+    template <size_t... I>
+    void EraseColumns(size_t index, std::index_sequence<I...>) {
+        (std::move(std::get<I>(columns_) + index + 1, std::get<I>(columns_) + size_, std::get<I>(columns_) + index),
+         ...);
+    }
+
+    template <size_t... I>
+    void SwapColumns(BasicSoaVector& other, std::index_sequence<I...>) noexcept {
+        (std::get<I>(columns_).Swap(std::get<I>(other.columns_)), ...);
+    }
+
+    Storage columns_;
+    size_t size_ = 0;
+};
+
+template <typename... Ts>
+using SoaVector = BasicSoaVector<std::allocator<char>, DoublingGrowth, Ts...>;
@@ -0,0 +1,268 @@
+#pragma once
+
+#include "vector.h"
+
+#include <stdexcept>
+
+// Хранилище StaticVector. Для тривиальных типов это обычный массив: тогда
+// StaticVector тривиально копируется и уничтожается и начиная с C++20 годится
+// для константных выражений. Остальные типы живут в объединении и конструируются
+// по мере добавления
+template <typename T, size_t N,
+          bool Trivial = std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>>
+class StaticVectorStorage {
+protected:
+    StaticVectorStorage() noexcept {}
+
+    StaticVectorStorage(const StaticVectorStorage& other) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+        std::uninitialized_copy_n(other.values_, other.size_, values_);
+        size_ = other.size_;
+    }
+
+    StaticVectorStorage(StaticVectorStorage&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        std::uninitialized_move_n(other.values_, other.size_, values_);
+        size_ = other.size_;
+    }
+
+    StaticVectorStorage& operator=(const StaticVectorStorage& rhs) {
+        if (this != &rhs) {
+            Assign(rhs.values_, rhs.size_, [](const T& value) -> const T& {
+                return value;
+            });
+        }
+        return *this;
+    }
+
+    StaticVectorStorage& operator=(StaticVectorStorage&& rhs) noexcept(std::is_nothrow_move_assignable_v<T>
+                                                                       && std::is_nothrow_move_constructible_v<T>) {
+        if (this != &rhs) {
+            Assign(rhs.values_, rhs.size_, [](T& value) -> T&& {
+                return std::move(value);
+            });
+        }
+        return *this;
+    }
+
+    ~StaticVectorStorage() {
+        std::destroy_n(values_, size_);
+    }
+
+    union {
+        T values_[N];
+    };
+    size_t size_ = 0;
+
+private:
+    // Базовая гарантия, как у копирующего присваивания Vector без реаллокации
+    template <typename Source, typename Cast>
+    void Assign(Source* source, size_t count, Cast cast) {
+        const size_t common = std::min(size_, count);
+        for (size_t i = 0; i < common; ++i) {
+            values_[i] = cast(source[i]);
+        }
+        if (size_ >= count) {
+            std::destroy(values_ + count, values_ + size_);
+            size_ = count;
+        } else {
+            for (; size_ < count; ++size_) {
+                new (values_ + size_) T(cast(source[size_]));
+            }
+        }
+    }
+};
+
+template <typename T, size_t N>
+class StaticVectorStorage<T, N, true> {
+protected:
+    // При компиляции каждый элемент должен быть инициализирован, а во время
+    // выполнения массив не нужно заполнять заранее
+    ADVANCED_VECTOR_CONSTEXPR StaticVectorStorage() noexcept {
+        if (IsConstantEvaluated()) {
+            for (T& value : values_) {
+                value = T();
+            }
+        }
+    }
+
+    T values_[N];
+    size_t size_ = 0;
+};
+
+// Вектор ёмкостью не больше N элементов, которые хранятся внутри объекта.
+// Куча не используется никогда: переполнение бросает std::length_error, а для кода,
+// где недопустимы и исключения, есть TryEmplaceBack и TryPushBack.
+// Ёмкость известна при компиляции через CAPACITY
+template <typename T, size_t N>
+class StaticVector : private StaticVectorStorage<T, N> {
+    static_assert(N > 0, "StaticVector needs a non-empty buffer");
+
+    using Storage = StaticVectorStorage<T, N>;
+    using Storage::values_;
+    using Storage::size_;
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr size_t CAPACITY = N;
+
+    StaticVector() = default;
+
+    ADVANCED_VECTOR_CONSTEXPR StaticVector(std::initializer_list<T> init) {
+        CheckSize(init.size());
+        for (const T& value : init) {
+            EmplaceBackUnchecked(value);
+        }
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR explicit StaticVector(size_t size) {
+        Resize(size);
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR iterator begin() noexcept {
+        return values_;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR iterator end() noexcept {
+        return values_ + size_;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const_iterator begin() const noexcept {
+        return values_;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const_iterator end() const noexcept {
+        return values_ + size_;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const_iterator cend() const noexcept {
+        return end();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR size_t Size() const noexcept {
+        return size_;
+    }
+
+    static constexpr size_t Capacity() noexcept {
+        return N;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR bool Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR bool Full() const noexcept {
+        return size_ == N;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR T* Data() noexcept {
+        return values_;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const T* Data() const noexcept {
+        return values_;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return values_[index];
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return values_[index];
+    }
+
+#ifdef __cpp_lib_span
+    operator std::span<T>() noexcept {
+        return std::span<T>(values_, size_);
+    }
+
+    operator std::span<const T>() const noexcept {
+        return std::span<const T>(values_, size_);
+    }
+#endif
+
+    template <typename... Args>
+    ADVANCED_VECTOR_CONSTEXPR T& EmplaceBack(Args&&... args) {
+        CheckSize(size_ + 1);
+        return EmplaceBackUnchecked(std::forward<Args>(args)...);
+    }
+
+    template <typename Value>
+    ADVANCED_VECTOR_CONSTEXPR void PushBack(Value&& value) {
+        EmplaceBack(std::forward<Value>(value));
+    }
+
+    // nullptr, если вектор заполнен
+    template <typename... Args>
+    ADVANCED_VECTOR_CONSTEXPR T* TryEmplaceBack(Args&&... args) {
+        return size_ < N ? &EmplaceBackUnchecked(std::forward<Args>(args)...) : nullptr;
+    }
+
+    template <typename Value>
+    ADVANCED_VECTOR_CONSTEXPR T* TryPushBack(Value&& value) {
+        return TryEmplaceBack(std::forward<Value>(value));
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        std::destroy_at(values_ + size_);
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR void Resize(size_t new_size) {
+        CheckSize(new_size);
+        if (new_size <= size_) {
+            std::destroy(values_ + new_size, values_ + size_);
+            size_ = new_size;
+            return;
+        }
+        // size_ растёт вместе с элементами, поэтому исключение не оставляет мусора
+        while (size_ < new_size) {
+            EmplaceBackUnchecked();
+        }
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR void Clear() noexcept {
+        std::destroy(values_, values_ + size_);
+        size_ = 0;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR iterator Erase(const_iterator pos) {
+        assert(pos >= cbegin() && pos < cend());
+        iterator it = begin() + (pos - cbegin());
+        std::move(it + 1, end(), it);
+        PopBack();
+        return it;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR iterator SwapErase(const_iterator pos) {
+        assert(pos >= cbegin() && pos < cend());
+        iterator it = begin() + (pos - cbegin());
+        if (it != end() - 1) {
+            *it = std::move(*(end() - 1));
+        }
+        PopBack();
+        return it;
+    }
+
+private:
+    static ADVANCED_VECTOR_CONSTEXPR void CheckSize(size_t size) {
+        if (size > N) {
+            throw std::length_error("StaticVector capacity exceeded");
+        }
+    }
+
+    template <typename... Args>
+    ADVANCED_VECTOR_CONSTEXPR T& EmplaceBackUnchecked(Args&&... args) {
+        T* slot = ConstructAt(values_ + size_, std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+};
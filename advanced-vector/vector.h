@@ -3,148 +3,647 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
 #include <memory>
 #include <new>
+#include <type_traits>
 #include <utility>
 
+#if __has_include(<span>)
+#include <span>
+#endif
+
+#include "parallel.h"
+
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+template <typename T, typename Deleter>
+struct IsTriviallyRelocatable<std::unique_ptr<T, Deleter>> : IsTriviallyRelocatable<Deleter> {};
+
+// Начиная с C++20 Vector и RawMemory можно использовать в константных выражениях:
+// для этого нужны constexpr-деструкторы и std::allocator, выделяющий память при компиляции
+#if defined(__cpp_constexpr_dynamic_alloc) && defined(__cpp_lib_constexpr_dynamic_alloc)
+#define ADVANCED_VECTOR_CONSTEXPR constexpr
+#define ADVANCED_VECTOR_HAS_CONSTEXPR 1
+#else
+#define ADVANCED_VECTOR_CONSTEXPR
+#endif
+
+// Рост буфера редок, поэтому его ветви помечаются маловероятными, а тяжёлые функции
+// роста выносятся из вызывающего кода. Атрибут cold не используется: GCC оптимизирует
+// такие функции по размеру и копирует память медленным rep movsb
+#if defined(__GNUC__)
+#define ADVANCED_VECTOR_NOINLINE __attribute__((noinline))
+#define ADVANCED_VECTOR_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+#elif defined(_MSC_VER)
+#define ADVANCED_VECTOR_NOINLINE __declspec(noinline)
+#define ADVANCED_VECTOR_UNLIKELY(condition) (condition)
+#else
+#define ADVANCED_VECTOR_NOINLINE
+#define ADVANCED_VECTOR_UNLIKELY(condition) (condition)
+#endif
+
+constexpr bool IsConstantEvaluated() noexcept {
+#ifdef __cpp_lib_is_constant_evaluated
+    return std::is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+// Размещающий new недоступен при компиляции, а std::construct_at появился только в C++20
+template <typename T, typename... Args>
+ADVANCED_VECTOR_CONSTEXPR T* ConstructAt(T* p, Args&&... args) {
+#ifdef ADVANCED_VECTOR_HAS_CONSTEXPR
+    return std::construct_at(p, std::forward<Args>(args)...);
+#else
+    return new (static_cast<void*>(p)) T(std::forward<Args>(args)...);
+#endif
+}
+
+// Алгоритмы std::uninitialized_* не constexpr до C++26. При компиляции исключение
+// всё равно делает выражение неконстантным, поэтому откатывать там нечего
+template <typename InputIt, typename T>
+ADVANCED_VECTOR_CONSTEXPR T* UninitializedCopy(InputIt first, InputIt last, T* to) {
+    if (IsConstantEvaluated()) {
+        for (; first != last; ++first, ++to) {
+            ConstructAt(to, *first);
+        }
+        return to;
+    }
+    return std::uninitialized_copy(first, last, to);
+}
+
+template <typename InputIt, typename T>
+ADVANCED_VECTOR_CONSTEXPR T* UninitializedCopyN(InputIt first, size_t count, T* to) {
+    if (IsConstantEvaluated()) {
+        for (size_t i = 0; i < count; ++i, ++first) {
+            ConstructAt(to + i, *first);
+        }
+        return to + count;
+    }
+    return std::uninitialized_copy_n(first, count, to);
+}
+
+template <typename T>
+ADVANCED_VECTOR_CONSTEXPR T* UninitializedMoveN(T* from, size_t count, T* to) {
+    if (IsConstantEvaluated()) {
+        for (size_t i = 0; i < count; ++i) {
+            ConstructAt(to + i, std::move(from[i]));
+        }
+        return to + count;
+    }
+    return std::uninitialized_move_n(from, count, to).second;
+}
+
+template <typename T>
+ADVANCED_VECTOR_CONSTEXPR T* UninitializedValueConstructN(T* to, size_t count) {
+    if (IsConstantEvaluated()) {
+        for (size_t i = 0; i < count; ++i) {
+            ConstructAt(to + i);
+        }
+        return to + count;
+    }
+    return std::uninitialized_value_construct_n(to, count);
+}
+
+// Переносит size элементов из from в неинициализированную память to, оставляя gap
+// свободных ячеек начиная с offset. Исходные элементы уничтожаются только после
+// успешного переноса всех элементов, поэтому копирование даёт строгую гарантию
+template <typename T>
+ADVANCED_VECTOR_CONSTEXPR void UninitializedRelocate(T* from, size_t size, T* to, size_t offset, size_t gap) {
+    assert(offset <= size);
+
+    if (IsConstantEvaluated()) {
+        // memcpy при компиляции недоступен
+        UninitializedMoveN(from, offset, to);
+        UninitializedMoveN(from + offset, size - offset, to + offset + gap);
+        std::destroy_n(from, size);
+        return;
+    }
+
+    if constexpr (IsTriviallyRelocatable<T>::value) {
+        if (size != 0) {
+            std::memcpy(static_cast<void*>(to), from, offset * sizeof(T));
+            std::memcpy(static_cast<void*>(to + offset + gap), from + offset, (size - offset) * sizeof(T));
+        }
+
+    } else {
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(from, offset, to);
+            try {
+                std::uninitialized_move_n(from + offset, size - offset, to + offset + gap);
+            } catch (...) {
+                std::destroy_n(to, offset);
+                throw;
+            }
+
+        } else {
+            std::uninitialized_copy_n(from, offset, to);
+            try {
+                std::uninitialized_copy_n(from + offset, size - offset, to + offset + gap);
+            } catch (...) {
+                std::destroy_n(to, offset);
+                throw;
+            }
+        }
+
+        std::destroy_n(from, size);
+    }
+}
+
+// Аллокатор может предоставить reallocate(p, old_n, new_n), меняющий размер блока
+// с сохранением его байтов. Тогда буферы побайтно переносимых типов растут на месте
+template <typename Alloc, typename = void>
+struct HasReallocate : std::false_type {};
+
+template <typename Alloc>
+struct HasReallocate<Alloc, std::void_t<decltype(std::declval<Alloc&>().reallocate(
+    std::declval<typename std::allocator_traits<Alloc>::pointer>(), size_t{}, size_t{}))>>
+    : std::true_type {};
+
 
 template <typename T>
+struct MallocAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc cannot satisfy the alignment of T");
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    MallocAllocator() = default;
+
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>& /*other*/) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(CheckAllocation(std::malloc(BytesFor(n))));
+    }
+
+    void deallocate(T* p, size_t /*n*/) noexcept {
+        std::free(p);
+    }
+
+    // realloc расширяет блок на месте, если за ним есть свободное место, а большие блоки,
+    // полученные через mmap, glibc переотображает через mremap без копирования
+    T* reallocate(T* p, size_t /*old_n*/, size_t new_n) {
+        return static_cast<T*>(CheckAllocation(std::realloc(static_cast<void*>(p), BytesFor(new_n))));
+    }
+
+    friend bool operator==(const MallocAllocator&, const MallocAllocator&) noexcept {
+        return true;
+    }
+
+    friend bool operator!=(const MallocAllocator&, const MallocAllocator&) noexcept {
+        return false;
+    }
+
+private:
+    static size_t BytesFor(size_t n) {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+
+    static void* CheckAllocation(void* p) {
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+};
+
+
+template <typename T, typename Alloc = std::allocator<T>>
 class RawMemory {
+    using AllocTraits = std::allocator_traits<Alloc>;
+
 public:
+    using allocator_type = Alloc;
+
     RawMemory() = default;
 
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
+    ADVANCED_VECTOR_CONSTEXPR explicit RawMemory(const Alloc& alloc) noexcept
+        : alloc_(alloc)
+    {}
+
+    ADVANCED_VECTOR_CONSTEXPR explicit RawMemory(size_t capacity, const Alloc& alloc = Alloc())
+        : alloc_(alloc)
+        , buffer_(Allocate(capacity))
         , capacity_(capacity)
     {}
 
     RawMemory(const RawMemory& other) = delete;
     RawMemory& operator=(const RawMemory& rhs) = delete;
     
-    RawMemory(RawMemory&& other) noexcept
-        : buffer_(std::exchange(other.buffer_, nullptr))
+    ADVANCED_VECTOR_CONSTEXPR RawMemory(RawMemory&& other) noexcept
+        : alloc_(std::move(other.alloc_))
+        , buffer_(std::exchange(other.buffer_, nullptr))
         , capacity_(std::exchange(other.capacity_, 0))
     {}
     
-    RawMemory& operator=(RawMemory&& rhs) noexcept {
+    ADVANCED_VECTOR_CONSTEXPR RawMemory& operator=(RawMemory&& rhs) noexcept {
         if (this != &rhs) {
-            buffer_ = std::exchange(rhs.buffer_, nullptr);
-            capacity_ = std::exchange(rhs.capacity_, 0);
+            RawMemory rhs_copy(std::move(rhs));
+            Swap(rhs_copy);
         }
 
         return *this;
     }
     
-    ~RawMemory() {
-        Deallocate(buffer_);
+    ADVANCED_VECTOR_CONSTEXPR ~RawMemory() {
+        Deallocate(buffer_, capacity_);
     }
 
-    T* operator+(size_t offset) noexcept {
+    ADVANCED_VECTOR_CONSTEXPR T* operator+(size_t offset) noexcept {
         assert(offset <= capacity_);
         return buffer_ + offset;
     }
 
-    const T* operator+(size_t offset) const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR const T* operator+(size_t offset) const noexcept {
         return const_cast<RawMemory&>(*this) + offset;
     }
 
-    T& operator[](size_t index) noexcept {
+    ADVANCED_VECTOR_CONSTEXPR T& operator[](size_t index) noexcept {
         assert(index < capacity_);
         return buffer_[index];
     }
 
-    const T& operator[](size_t index) const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR const T& operator[](size_t index) const noexcept {
         return const_cast<RawMemory&>(*this)[index];
     }
 
-    void Swap(RawMemory& other) noexcept {
-        std::swap(buffer_, other.buffer_);
-        std::swap(capacity_, other.capacity_);
+    ADVANCED_VECTOR_CONSTEXPR void Swap(RawMemory& other) noexcept {
+        using std::swap;
+        swap(alloc_, other.alloc_);
+        swap(buffer_, other.buffer_);
+        swap(capacity_, other.capacity_);
     }
 
-    const T* GetAddress() const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR const T* GetAddress() const noexcept {
         return buffer_;
     }
 
-    T* GetAddress() noexcept {
+    ADVANCED_VECTOR_CONSTEXPR T* GetAddress() noexcept {
         return buffer_;
     }
 
-    size_t Capacity() const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR size_t Capacity() const noexcept {
         return capacity_;
     }
 
+    ADVANCED_VECTOR_CONSTEXPR Alloc& GetAllocator() noexcept {
+        return alloc_;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const Alloc& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    // Меняет ёмкость, сохраняя байты первых min(Capacity(), new_capacity) ячеек.
+    // Адрес буфера может измениться, поэтому годится только для побайтно переносимых T
+    void Reallocate(size_t new_capacity) {
+        static_assert(HasReallocate<Alloc>::value, "Alloc does not provide reallocate()");
+
+        if (new_capacity == 0) {
+            Deallocate(buffer_, capacity_);
+            buffer_ = nullptr;
+        } else if (buffer_ == nullptr) {
+            buffer_ = Allocate(new_capacity);
+        } else {
+            buffer_ = alloc_.reallocate(buffer_, capacity_, new_capacity);
+        }
+
+        capacity_ = new_capacity;
+    }
+
+    // Освобождает текущий буфер и берёт во владение buffer, выделенный аллокатором,
+    // равным GetAllocator(), на capacity элементов
+    void Adopt(T* buffer, size_t capacity) noexcept {
+        Deallocate(buffer_, capacity_);
+        buffer_ = buffer;
+        capacity_ = capacity;
+    }
+
+    // Отдаёт буфер вызывающему, который должен освободить его тем же аллокатором
+    T* Release() noexcept {
+        capacity_ = 0;
+        return std::exchange(buffer_, nullptr);
+    }
+
 private:
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new (n * sizeof(T))) : nullptr; 
+    ADVANCED_VECTOR_CONSTEXPR T* Allocate(size_t n) {
+        return n != 0 ? AllocTraits::allocate(alloc_, n) : nullptr;
     }
 
-    static void Deallocate(T* buf) noexcept {
-        operator delete (buf);
+    ADVANCED_VECTOR_CONSTEXPR void Deallocate(T* buf, size_t n) noexcept {
+        if (buf != nullptr) {
+            AllocTraits::deallocate(alloc_, buf, n);
+        }
     }
 
+    [[no_unique_address]] Alloc alloc_;
     T* buffer_ = nullptr;
     size_t capacity_ = 0;
 };
 
 
+// Тег конструктора, оставляющего элементы тривиальных типов неинициализированными
+struct DefaultInitTag {
+    explicit DefaultInitTag() = default;
+};
+
+inline constexpr DefaultInitTag default_init{};
+
+template <typename It>
+using IteratorCategory = typename std::iterator_traits<It>::iterator_category;
+
+template <typename It, typename = void>
+struct IsInputIterator : std::false_type {};
+
+template <typename It>
+struct IsInputIterator<It, std::void_t<IteratorCategory<It>>>
+    : std::is_convertible<IteratorCategory<It>, std::input_iterator_tag> {};
+
+template <typename It>
+inline constexpr bool IS_FORWARD_ITERATOR = std::is_convertible_v<IteratorCategory<It>, std::forward_iterator_tag>;
+
+
+// Политика роста определяет новую ёмкость, когда в буфере не осталось места.
+// NewCapacity получает текущую ёмкость, минимально необходимую ёмкость и sizeof(T)
+struct DoublingGrowth {
+    static constexpr size_t NewCapacity(size_t capacity, size_t required, size_t /*element_size*/) noexcept {
+        return std::max(required, capacity == 0 ? 1 : capacity * 2);
+    }
+};
+
+// При росте в 1.5 раза сумма освобождённых блоков со временем превышает запрос,
+// и аллокатор может переиспользовать их для следующего буфера
+struct OneAndHalfGrowth {
+    static constexpr size_t NewCapacity(size_t capacity, size_t required, size_t /*element_size*/) noexcept {
+        return std::max(required, capacity < 2 ? capacity + 1 : capacity + capacity / 2);
+    }
+};
+
+// Первая аллокация занимает не меньше MinBytes байт, что избавляет от цепочки 1, 2, 4, 8...
+template <typename Base = DoublingGrowth, size_t MinBytes = 64>
+struct MinCapacityGrowth {
+    static constexpr size_t NewCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t min_capacity = std::max<size_t>(1, MinBytes / element_size);
+        return std::max(Base::NewCapacity(capacity, required, element_size), min_capacity);
+    }
+};
+
+// Округляет размер буфера до класса размера аллокатора: маленькие блоки до степени двойки,
+// блоки от PageSize байт до целого числа страниц. Хвост блока достаётся вектору бесплатно
+template <typename Base = DoublingGrowth, size_t PageSize = 4096>
+struct SizeClassGrowth {
+    static_assert((PageSize & (PageSize - 1)) == 0, "PageSize must be a power of two");
+
+    static constexpr size_t NewCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t bytes = Base::NewCapacity(capacity, required, element_size) * element_size;
+
+        size_t rounded = PageSize;
+        if (bytes >= PageSize) {
+            rounded = (bytes + PageSize - 1) & ~(PageSize - 1);
+        } else {
+            while (rounded / 2 >= bytes) {
+                rounded /= 2;
+            }
+        }
+
+        return rounded / element_size;
+    }
+};
+
+
+// Политика роста может определить ShrinkCapacity(capacity, size, element_size), которая
+// возвращает ёмкость после удаления элементов. Тогда вектор сам отдаёт лишнюю память
+template <typename Growth, typename = void>
+struct HasShrinkCapacity : std::false_type {};
+
+template <typename Growth>
+struct HasShrinkCapacity<Growth, std::void_t<decltype(Growth::ShrinkCapacity(size_t{}, size_t{}, size_t{}))>>
+    : std::true_type {};
+
+// Уменьшает буфер, когда элементы занимают меньше 1/Divisor его ёмкости. Новая ёмкость
+// берётся у Base, как при росте с нуля, чтобы следующие вставки не вызывали реаллокацию
+template <typename Base = DoublingGrowth, size_t Divisor = 4>
+struct ShrinkingGrowth {
+    static_assert(Divisor >= 2, "Shrinking at a smaller ratio than growing would thrash");
+
+    static constexpr size_t NewCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        return Base::NewCapacity(capacity, required, element_size);
+    }
+
+    static constexpr size_t ShrinkCapacity(size_t capacity, size_t size, size_t element_size) noexcept {
+        if (size >= capacity / Divisor) {
+            return capacity;
+        }
+        return size == 0 ? 0 : std::min(capacity, Base::NewCapacity(size, size, element_size));
+    }
+};
+
+// Буфер, переданный вектору или полученный от него без копирования элементов
 template <typename T>
+struct VectorBuffer {
+    T* data = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+};
+
+enum class RelocationKind {
+    BYTEWISE,
+    MOVE,
+    COPY,
+};
+
+// Политика статистики получает уведомления о работе с памятью и сдвигах элементов.
+// NoVectorStats пуста, и после встраивания от вызовов её методов не остаётся кода.
+// Считающие политики находятся в vector_stats.h
+struct NoVectorStats {
+    constexpr void OnAllocate(size_t /*capacity*/, size_t /*element_size*/) noexcept {}
+    constexpr void OnDeallocate(size_t /*capacity*/, size_t /*element_size*/) noexcept {}
+    constexpr void OnReallocate(size_t /*old_capacity*/, size_t /*new_capacity*/, size_t /*element_size*/) noexcept {}
+    constexpr void OnRelocate(size_t /*count*/, RelocationKind /*kind*/) noexcept {}
+    constexpr void OnInsertShift(size_t /*count*/) noexcept {}
+    constexpr void OnEraseShift(size_t /*count*/) noexcept {}
+};
+
+// Политика может объявить OnSize(size, element_size): Vector сообщает ей свой размер
+// после каждой операции, меняющей размер или буфер, в том числе после каждого PushBack
+// и PopBack, поэтому политика должна лишь запомнить его у себя, не обращаясь к общим
+// счётчикам. Для политик без OnSize вызовы не компилируются.
+// Операция, прерванная исключением, может не сообщить новый размер: его сообщит следующая
+template <typename Stats, typename = void>
+struct HasSizeHook : std::false_type {};
+
+template <typename Stats>
+struct HasSizeHook<Stats, std::void_t<decltype(std::declval<Stats&>().OnSize(size_t{}, size_t{}))>>
+    : std::true_type {};
+
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth,
+          typename Stats = NoVectorStats>
 class Vector {
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    static constexpr bool GROWS_IN_PLACE = IsTriviallyRelocatable<T>::value && HasReallocate<Alloc>::value;
+
+    static constexpr RelocationKind RELOCATION_KIND =
+        IsTriviallyRelocatable<T>::value ? RelocationKind::BYTEWISE
+        : std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T> ? RelocationKind::MOVE
+                                                                                       : RelocationKind::COPY;
+
+    using Untracked = Vector<T, Alloc, Growth, NoVectorStats>;
+
+    template <typename, typename, typename, typename>
+    friend class Vector;
+
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>,
+                  "Vector must have the same value_type as its allocator");
+
 public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using growth_policy = Growth;
+    using stats_policy = Stats;
     using iterator = T*;
     using const_iterator = const T*;
 
-    iterator begin() noexcept {
+    ADVANCED_VECTOR_CONSTEXPR iterator begin() noexcept {
         return data_ + 0;
     }
 
-    iterator end() noexcept {
+    ADVANCED_VECTOR_CONSTEXPR iterator end() noexcept {
         return data_ + size_;
     }
 
-    const_iterator begin() const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR const_iterator begin() const noexcept {
         return data_ + 0;
     }
-    const_iterator end() const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR const_iterator end() const noexcept {
         return data_ + size_;
     }
 
-    const_iterator cbegin() const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR const_iterator cbegin() const noexcept {
         return data_ + 0;
     }
-    const_iterator cend() const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR const_iterator cend() const noexcept {
         return data_ + size_;
     }
 
 
     Vector() = default;
+
+    ADVANCED_VECTOR_CONSTEXPR explicit Vector(const Alloc& alloc) noexcept
+        : data_(alloc)
+    {}
         
-    explicit Vector(size_t size)
-    : data_(size)
+    ADVANCED_VECTOR_CONSTEXPR explicit Vector(size_t size, const Alloc& alloc = Alloc())
+    : data_(size, alloc)
     , size_(size)
     {   
-        std::uninitialized_value_construct_n(data_.GetAddress(), size);    
+        UninitializedValueConstructN(data_.GetAddress(), size);
+        stats_.OnAllocate(size, sizeof(T));
+        ReportSize();
+    }
+
+    Vector(size_t size, DefaultInitTag, const Alloc& alloc = Alloc())
+        : data_(size, alloc)
+        , size_(size)
+    {
+        std::uninitialized_default_construct_n(data_.GetAddress(), size);
+        stats_.OnAllocate(size, sizeof(T));
+        ReportSize();
     }
     
-    Vector(const Vector& other)
-        : data_(other.size_)
+    ADVANCED_VECTOR_CONSTEXPR Vector(const Vector& other)
+        : Vector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator()))
+    {}
+
+    ADVANCED_VECTOR_CONSTEXPR Vector(const Vector& other, const Alloc& alloc)
+        : data_(other.size_, alloc)
         , size_(other.size_)
     {
-        std::uninitialized_copy_n(other.data_.GetAddress(), other.size_, data_.GetAddress()); 
+        UninitializedCopyN(other.data_.GetAddress(), other.size_, data_.GetAddress());
+        stats_.OnAllocate(other.size_, sizeof(T));
+        ReportSize();
     }
     
-    Vector(Vector&& other) noexcept
+    // Параллельные версии конструкторов для больших векторов, см. ParallelPolicy
+    Vector(const ParallelPolicy& policy, size_t size, const Alloc& alloc = Alloc())
+        : data_(size, alloc)
+    {
+        ParallelUninitializedValueConstructN(policy, data_.GetAddress(), size);
+        size_ = size;
+        stats_.OnAllocate(size, sizeof(T));
+        ReportSize();
+    }
+
+    Vector(const ParallelPolicy& policy, const Vector& other)
+        : data_(other.size_, AllocTraits::select_on_container_copy_construction(other.GetAllocator()))
+    {
+        ParallelUninitializedCopyN(policy, other.data_.GetAddress(), other.size_, data_.GetAddress());
+        size_ = other.size_;
+        stats_.OnAllocate(size_, sizeof(T));
+        ReportSize();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR Vector(Vector&& other) noexcept
         : data_(std::move(other.data_))
         , size_(std::exchange(other.size_, 0))
+        , stats_(std::exchange(other.stats_, Stats()))
+    {}
+
+    template <typename InputIt, typename = std::enable_if_t<IsInputIterator<InputIt>::value>>
+    // Делегирование нужно, чтобы при исключении из EmplaceBack деструктор освободил
+    // уже созданные элементы
+    ADVANCED_VECTOR_CONSTEXPR Vector(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+        : Vector(alloc)
+    {
+        if constexpr (IS_FORWARD_ITERATOR<InputIt>) {
+            const size_t count = std::distance(first, last);
+            RawMemory<T, Alloc> new_data(count, alloc);
+            UninitializedCopy(first, last, new_data.GetAddress());
+            data_.Swap(new_data);
+            size_ = count;
+            stats_.OnAllocate(count, sizeof(T));
+            ReportSize();
+        } else {
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+        }
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR Vector(std::initializer_list<T> init, const Alloc& alloc = Alloc())
+        : Vector(init.begin(), init.end(), alloc)
     {}
     
-    Vector& operator=(const Vector& rhs) {
+    ADVANCED_VECTOR_CONSTEXPR Vector& operator=(const Vector& rhs) {
         if (this != &rhs) {
 
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value
+                          && !AllocTraits::is_always_equal::value) {
+                if (GetAllocator() != rhs.GetAllocator()) {
+                    Untracked rhs_copy(rhs.begin(), rhs.end(), rhs.GetAllocator());
+                    ReplaceWith(rhs_copy);
+                    return *this;
+                }
+            }
+
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                data_.GetAllocator() = rhs.GetAllocator();
+            }
+
             if (rhs.size_ > data_.Capacity()) {
 
-                Vector rhs_copy(rhs);
-                Swap(rhs_copy);
+                Untracked rhs_copy(rhs.begin(), rhs.end(), GetAllocator());
+                ReplaceWith(rhs_copy);
 
             } else {
                 
@@ -155,113 +654,254 @@ public:
                     std::destroy_n(data_ + rhs.size_, size_ - rhs.size_);
                 
                 } else {
-                    std::uninitialized_copy_n(rhs.data_ + size_, rhs.size_ - size_, data_ + size_);
+                    UninitializedCopyN(rhs.data_ + size_, rhs.size_ - size_, data_ + size_);
                 }
             }
 
             size_ = rhs.size_;
+            ReportSize();
         }
 
         return *this;
     }
 
-    Vector& operator=(Vector&& rhs) noexcept {
+    ADVANCED_VECTOR_CONSTEXPR Vector& operator=(Vector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                             || AllocTraits::is_always_equal::value) {
         if (this != &rhs) {
+
+            if constexpr (!AllocTraits::propagate_on_container_move_assignment::value
+                          && !AllocTraits::is_always_equal::value) {
+                if (GetAllocator() != rhs.GetAllocator()) {
+                    MoveAssignElements(rhs);
+                    return *this;
+                }
+            }
+
+            std::destroy_n(data_.GetAddress(), size_);
+            stats_.OnDeallocate(Capacity(), sizeof(T));
             data_ = std::move(rhs.data_);
             size_ = std::exchange(rhs.size_, 0);
+            // Счётчики следуют за буфером, как в конструкторе перемещения
+            stats_ = std::exchange(rhs.stats_, Stats());
+            ReportSize();
+            rhs.ReportSize();
         }
 
         return *this;
     }
 
-    void Swap(Vector& other) noexcept {
+    ADVANCED_VECTOR_CONSTEXPR void Swap(Vector& other) noexcept {
+        if constexpr (!AllocTraits::propagate_on_container_swap::value
+                      && !AllocTraits::is_always_equal::value) {
+            assert(GetAllocator() == other.GetAllocator());
+        }
+
         if (this != &other) {
-            data_.Swap(other.data_);
-            std::swap(size_, other.size_);
+            SwapStorage(other);
         }
     }
+
+    ADVANCED_VECTOR_CONSTEXPR Alloc GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const Stats& GetStats() const noexcept {
+        return stats_;
+    }
+
+    // Заменяет содержимое буфером data, в котором сконструированы size элементов.
+    // Буфер должен быть выделен аллокатором, равным GetAllocator(), ровно на capacity элементов
+    void Adopt(T* data, size_t size, size_t capacity) noexcept {
+        assert(size <= capacity && (data != nullptr || capacity == 0));
+
+        std::destroy_n(data_.GetAddress(), size_);
+        stats_.OnDeallocate(Capacity(), sizeof(T));
+        data_.Adopt(data, capacity);
+        size_ = size;
+        stats_.OnAllocate(capacity, sizeof(T));
+        ReportSize();
+    }
+
+    // Отдаёт буфер вместе с элементами, оставляя вектор пустым. Элементы уничтожает
+    // и буфер освобождает аллокатором GetAllocator() новый владелец
+    [[nodiscard]] VectorBuffer<T> Release() noexcept {
+        VectorBuffer<T> buffer{data_.GetAddress(), size_, Capacity()};
+        stats_.OnDeallocate(Capacity(), sizeof(T));
+        data_.Release();
+        size_ = 0;
+        ReportSize();
+        return buffer;
+    }
+
+#ifdef __cpp_lib_span
+    operator std::span<T>() noexcept {
+        return std::span<T>(data_.GetAddress(), size_);
+    }
+
+    operator std::span<const T>() const noexcept {
+        return std::span<const T>(data_.GetAddress(), size_);
+    }
+#endif
     
-    ~Vector() {
+    ADVANCED_VECTOR_CONSTEXPR ~Vector() {
         std::destroy_n(data_.GetAddress(), size_);
+        stats_.OnDeallocate(Capacity(), sizeof(T));
     }
     
-    size_t Size() const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR size_t Size() const noexcept {
         return size_;
     }
 
-    size_t Capacity() const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR size_t Capacity() const noexcept {
         return data_.Capacity();
     }
 
-    T& operator[](size_t index) noexcept {
+    // Байты, которые занимает буфер, включая незанятые ячейки Capacity() - Size()
+    ADVANCED_VECTOR_CONSTEXPR size_t MemoryUsage() const noexcept {
+        return Capacity() * sizeof(T);
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR T& operator[](size_t index) noexcept {
         return data_[index];
     }
     
-    const T& operator[](size_t index) const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR const T& operator[](size_t index) const noexcept {
         return const_cast<Vector&>(*this)[index];
     }
 
-    void Reserve(size_t new_capacity) {
+    ADVANCED_VECTOR_CONSTEXPR void Reserve(size_t new_capacity) {
         if (new_capacity <= data_.Capacity()) {
             return;
         }
 
-        RawMemory<T> new_data(new_capacity);
-        
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-        } else {
-            std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
+        ReallocateStorage(new_capacity);
+    }
+
+    // Уменьшает ёмкость до Size(). Даёт строгую гарантию
+    ADVANCED_VECTOR_CONSTEXPR void ShrinkToFit() {
+        if (size_ != Capacity()) {
+            ReallocateStorage(size_);
         }
+    }
 
+    ADVANCED_VECTOR_CONSTEXPR void Clear() noexcept {
         std::destroy_n(data_.GetAddress(), size_);
-        data_.Swap(new_data);
+        size_ = 0;
+        MaybeShrink();
     }
 
-    void Resize(size_t new_size) {
+    ADVANCED_VECTOR_CONSTEXPR void Resize(size_t new_size) {
         if (new_size <= size_) {
             std::destroy_n(data_ + new_size, size_ - new_size);
         } else {
             Reserve(new_size);
-            std::uninitialized_value_construct_n(data_ + size_, new_size - size_);
+            UninitializedValueConstructN(data_ + size_, new_size - size_);
         }
 
         size_ = new_size;
+        MaybeShrink();
     }
-    
-    template <typename... Args>
-    T& EmplaceBack(Args&&... args) {
-        if (size_ == Capacity()) {
 
-            RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
-            new (new_data + size_) T(std::forward<Args>(args)...);
-        
+    void Resize(const ParallelPolicy& policy, size_t new_size) {
+        if (new_size <= size_) {
+            ParallelDestroyN(policy, data_ + new_size, size_ - new_size);
+        } else {
+            Reserve(new_size);
+            ParallelUninitializedValueConstructN(policy, data_ + size_, new_size - size_);
+        }
 
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-            } else {
-                std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
+        size_ = new_size;
+        MaybeShrink();
+    }
 
-            std::destroy_n(data_.GetAddress(), size_);
-            data_.Swap(new_data);
+    // Параллельная версия копирующего присваивания. Аллокатор не меняется
+    void Assign(const ParallelPolicy& policy, const Vector& rhs) {
+        if (this == &rhs) {
+            return;
+        }
+
+        if (rhs.size_ > data_.Capacity()) {
+            Untracked rhs_copy(GetAllocator());
+            rhs_copy.ParallelCopyConstruct(policy, rhs.data_.GetAddress(), rhs.size_);
+            ReplaceWith(rhs_copy);
+            return;
+        }
+
+        const size_t min = std::min(size_, rhs.size_);
+        ParallelCopyN(policy, rhs.data_.GetAddress(), min, data_.GetAddress());
+
+        if (size_ >= rhs.size_) {
+            ParallelDestroyN(policy, data_ + rhs.size_, size_ - rhs.size_);
+        } else {
+            ParallelUninitializedCopyN(policy, rhs.data_ + size_, rhs.size_ - size_, data_ + size_);
+        }
+
+        size_ = rhs.size_;
+        ReportSize();
+    }
+
+    // Деструктор уничтожает элементы в одном потоке; чтобы сделать это параллельно,
+    // вектор очищают этим методом заранее
+    void Clear(const ParallelPolicy& policy) noexcept {
+        ParallelDestroyN(policy, data_.GetAddress(), size_);
+        size_ = 0;
+        MaybeShrink();
+    }
 
+    // Как Resize, но новые элементы инициализируются по умолчанию: для тривиальных типов
+    // память не обнуляется, что полезно для буферов, которые сразу будут перезаписаны
+    void ResizeDefaultInit(size_t new_size) {
+        if (new_size <= size_) {
+            std::destroy_n(data_ + new_size, size_ - new_size);
         } else {
-            new (data_ + size_) T(std::forward<Args>(args)...);
+            Reserve(new_size);
+            std::uninitialized_default_construct_n(data_ + size_, new_size - size_);
         }
 
-        return data_[size_++];
+        size_ = new_size;
+        MaybeShrink();
+    }
+
+#ifdef __cpp_lib_span
+    // Добавляет count элементов без инициализации и возвращает их для записи.
+    // Подходит только для типов, время жизни которых начинается неявно
+    std::span<T> AppendUninitialized(size_t count) {
+        static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                      "AppendUninitialized requires an implicit-lifetime type");
+
+        if (size_ + count > Capacity()) {
+            Reserve(NextCapacity(size_ + count));
+        }
+
+        const size_t offset = std::exchange(size_, size_ + count);
+        ReportSize();
+        return std::span<T>(data_ + offset, count);
+    }
+#endif
+    
+    template <typename... Args>
+    ADVANCED_VECTOR_CONSTEXPR T& EmplaceBack(Args&&... args) {
+        if (ADVANCED_VECTOR_UNLIKELY(size_ == Capacity())) {
+            GrowAndInsert(size_, std::forward<Args>(args)...);
+        } else {
+            ConstructAt(data_ + size_, std::forward<Args>(args)...);
+        }
+
+        T& item = data_[size_++];
+        ReportSize();
+        return item;
     }
        
     template <typename Value>
-    void PushBack(Value&& value) {
+    ADVANCED_VECTOR_CONSTEXPR void PushBack(Value&& value) {
         EmplaceBack(std::forward<Value>(value));
     }
 
-    void PopBack() {
+    ADVANCED_VECTOR_CONSTEXPR void PopBack() {
         assert(size_ != 0);
         std::destroy_at(data_ + size_ - 1);
         --size_;
+        MaybeShrink();
     }
     
     template <typename... Args>
@@ -270,20 +910,14 @@ public:
         
         std::size_t offset = pos - cbegin();
  
-        if (size_ == Capacity()) {
-            InsertAndReallocate(offset, std::forward<Args>(args)...);
-            
+        if (ADVANCED_VECTOR_UNLIKELY(size_ == Capacity())) {
+            GrowAndInsert(offset, std::forward<Args>(args)...);
         } else {
-            try {
-                InsertWithoutReallocating(pos, offset, std::forward<Args>(args)...);
-
-            } catch (...) {
-                operator delete (end());
-                throw;
-            }
+            InsertWithoutReallocating(pos, offset, std::forward<Args>(args)...);
         }
-        
+
         ++size_;
+        ReportSize();
 
         return begin() + offset;
     }
@@ -296,54 +930,450 @@ public:
         return Emplace(pos, std::move(value));
     }
 
-    iterator Erase(const_iterator pos) {
+    // Для forward-итераторов память выделяется не более одного раза,
+    // а хвост вектора сдвигается на всю длину диапазона за один проход
+    template <typename InputIt, typename = std::enable_if_t<IsInputIterator<InputIt>::value>>
+    iterator Insert(const_iterator pos, InputIt first, InputIt last) {
         assert(pos >= cbegin() && pos <= cend());
 
         std::size_t offset = pos - cbegin();
 
-        std::move(begin() + offset + 1, end(), begin() + offset);
-        std::destroy_at(cend() - 1);
-        --size_;
+        if constexpr (IS_FORWARD_ITERATOR<InputIt>) {
+            const std::size_t count = std::distance(first, last);
+
+            if (size_ + count > Capacity()) {
+                InsertRangeAndReallocate(offset, first, last, count);
+            } else if (count != 0) {
+                InsertRangeWithoutReallocating(offset, first, last, count);
+            }
+
+        } else {
+            const std::size_t old_size = size_;
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+            std::rotate(begin() + offset, begin() + old_size, end());
+        }
+
+        ReportSize();
+        return begin() + offset;
+    }
+
+    iterator Insert(const_iterator pos, std::initializer_list<T> init) {
+        return Insert(pos, init.begin(), init.end());
+    }
+
+    template <typename InputIt, typename = std::enable_if_t<IsInputIterator<InputIt>::value>>
+    void Append(InputIt first, InputIt last) {
+        Insert(cend(), first, last);
+    }
+
+    void Append(std::initializer_list<T> init) {
+        Insert(cend(), init.begin(), init.end());
+    }
+
+    template <typename InputIt, typename = std::enable_if_t<IsInputIterator<InputIt>::value>>
+    void Assign(InputIt first, InputIt last) {
+        if constexpr (IS_FORWARD_ITERATOR<InputIt>) {
+            const std::size_t count = std::distance(first, last);
+
+            if (count > Capacity()) {
+                Untracked replacement(first, last, GetAllocator());
+                ReplaceWith(replacement);
+                return;
+            }
+
+            InputIt mid = first;
+            std::advance(mid, std::min(size_, count));
+            std::copy(first, mid, begin());
+
+            if (size_ >= count) {
+                std::destroy_n(data_ + count, size_ - count);
+                size_ = count;
+            } else {
+                std::uninitialized_copy(mid, last, end());
+                size_ = count;
+            }
+
+        } else {
+            iterator it = begin();
+            for (; first != last && it != end(); ++first, ++it) {
+                *it = *first;
+            }
+
+            if (first == last) {
+                const std::size_t count = it - begin();
+                std::destroy_n(data_ + count, size_ - count);
+                size_ = count;
+            } else {
+                for (; first != last; ++first) {
+                    EmplaceBack(*first);
+                }
+            }
+        }
+
+        ReportSize();
+    }
+
+    void Assign(std::initializer_list<T> init) {
+        Assign(init.begin(), init.end());
+    }
+
+    iterator Erase(const_iterator pos) {
+        assert(pos >= cbegin() && pos < cend());
+
+        return Erase(pos, pos + 1);
+    }
+
+    iterator Erase(const_iterator first, const_iterator last) {
+        assert(first >= cbegin() && first <= last && last <= cend());
+
+        const std::size_t offset = first - cbegin();
+        const std::size_t count = last - first;
+
+        if (count == 0) {
+            return begin() + offset;
+        }
+
+        stats_.OnEraseShift(size_ - offset - count);
+
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            std::destroy_n(data_ + offset, count);
+            std::memmove(static_cast<void*>(data_ + offset), data_ + offset + count,
+                         (size_ - offset - count) * sizeof(T));
+        } else {
+            std::move(begin() + offset + count, end(), begin() + offset);
+            std::destroy_n(end() - count, count);
+        }
+
+        size_ -= count;
+        MaybeShrink();
+
+        return begin() + offset;
+    }
+
+    // Удаляет элемент за O(1), не сохраняя порядок: на его место переезжает последний.
+    // Возвращает итератор на переехавший элемент или end(), если удалялся последний
+    iterator SwapErase(const_iterator pos) {
+        assert(pos >= cbegin() && pos < cend());
+
+        return UnorderedErase(pos, pos + 1);
+    }
+
+    // Удаляет диапазон, заполняя его последними элементами вектора. Переезжает
+    // не больше last - first элементов, сколько бы их ни стояло после диапазона
+    iterator UnorderedErase(const_iterator first, const_iterator last) {
+        assert(first >= cbegin() && first <= last && last <= cend());
+
+        const std::size_t offset = first - cbegin();
+        const std::size_t count = last - first;
+        const std::size_t moved = std::min(count, size_ - offset - count);
+
+        if (count == 0) {
+            return begin() + offset;
+        }
+
+        stats_.OnEraseShift(moved);
+
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            std::destroy_n(data_ + offset, count);
+            std::memcpy(static_cast<void*>(data_ + offset), data_ + size_ - moved, moved * sizeof(T));
+        } else {
+            std::move(end() - moved, end(), begin() + offset);
+            std::destroy_n(begin() + offset + moved, count - moved);
+            std::destroy_n(end() - moved, moved);
+        }
+
+        size_ -= count;
+        MaybeShrink();
 
         return begin() + offset;
     }
 
+    // Удаляет элементы, удовлетворяющие pred, за один проход и возвращает их количество.
+    // Побайтно переносимые элементы сдвигаются memmove целыми сериями между удалёнными
+    template <typename Pred>
+    std::size_t EraseIf(Pred pred) {
+        const std::size_t old_size = size_;
+
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            T* const first = begin();
+            T* const last = end();
+            T* write = first;
+            T* pending = first;
+
+            const auto move_pending = [&](T* until) {
+                if (write != pending) {
+                    std::memmove(static_cast<void*>(write), pending, (until - pending) * sizeof(T));
+                }
+                write += until - pending;
+            };
+
+            try {
+                for (T* read = first; read != last; ++read) {
+                    if (pred(*read)) {
+                        move_pending(read);
+                        std::destroy_at(read);
+                        pending = read + 1;
+                    }
+                }
+            } catch (...) {
+                move_pending(last);
+                size_ = write - first;
+                ReportSize();
+                throw;
+            }
+
+            move_pending(last);
+            size_ = write - first;
+            MaybeShrink();
+
+        } else {
+            Erase(std::remove_if(begin(), end(), pred), end());
+        }
+
+        return old_size - size_;
+    }
+
 private:
+    // Общий медленный путь EmplaceBack, PushBack и Emplace. Размер увеличивает вызывающий:
+    // тогда он остаётся в регистре на обеих ветвях.
+    // Для типов, которые переносятся memcpy, рост короткий и остаётся встроенным: вызов
+    // внешней функции заставил бы хранить data_ и size_ в памяти, и цикл PushBack для int
+    // замедлился бы вдвое. Остальные типы растут поэлементно с обработкой исключений,
+    // и этот код выносится из горячего цикла
     template <typename... Args>
-    void InsertAndReallocate(std::size_t offset, Args&&... args) {
-        RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
-        new (new_data.GetAddress() + offset) T(std::forward<Args>(args)...);
- 
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(data_.GetAddress(), offset, new_data.GetAddress());
-            std::uninitialized_move_n(data_.GetAddress() + offset, size_ - offset, 
-                                      new_data.GetAddress() + offset + 1);
-            
+    ADVANCED_VECTOR_CONSTEXPR void GrowAndInsert(std::size_t offset, Args&&... args) {
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            InsertAndReallocate(offset, std::forward<Args>(args)...);
         } else {
-            std::uninitialized_copy_n(data_.GetAddress(), offset, new_data.GetAddress());
-            std::uninitialized_copy_n(data_.GetAddress() + offset, size_ - offset, 
-                                      new_data.GetAddress() + offset + 1);
+            OutlinedInsertAndReallocate(offset, std::forward<Args>(args)...);
         }
- 
-        std::destroy_n(data_.GetAddress(), size_);
+    }
+
+    template <typename... Args>
+    ADVANCED_VECTOR_NOINLINE ADVANCED_VECTOR_CONSTEXPR void OutlinedInsertAndReallocate(std::size_t offset, Args&&... args) {
+        InsertAndReallocate(offset, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    ADVANCED_VECTOR_CONSTEXPR void InsertAndReallocate(std::size_t offset, Args&&... args) {
+        if constexpr (GROWS_IN_PLACE) {
+            // Аргументы могут ссылаться на элементы вектора, которые realloc может перенести
+            T temp(std::forward<Args>(args)...);
+            ReallocateInPlace(NextCapacity(size_ + 1));
+            std::memmove(static_cast<void*>(data_ + offset + 1), data_ + offset, (size_ - offset) * sizeof(T));
+            new (data_ + offset) T(std::move(temp));
+            return;
+        }
+
+        RawMemory<T, Alloc> new_data(NextCapacity(size_ + 1), data_.GetAllocator());
+        ConstructAt(new_data.GetAddress() + offset, std::forward<Args>(args)...);
+
+        try {
+            RelocateInto(new_data, offset, 1);
+        } catch (...) {
+            std::destroy_at(new_data.GetAddress() + offset);
+            throw;
+        }
+
+        AdoptStorage(new_data);
+    }
+
+    template <typename ForwardIt>
+    ADVANCED_VECTOR_NOINLINE void InsertRangeAndReallocate(std::size_t offset, ForwardIt first, ForwardIt last, std::size_t count) {
+        if constexpr (GROWS_IN_PLACE) {
+            ReallocateInPlace(NextCapacity(size_ + count));
+            InsertRangeWithoutReallocating(offset, first, last, count);
+            return;
+        }
+
+        RawMemory<T, Alloc> new_data(NextCapacity(size_ + count), data_.GetAllocator());
+        std::uninitialized_copy(first, last, new_data.GetAddress() + offset);
+
+        try {
+            RelocateInto(new_data, offset, count);
+        } catch (...) {
+            std::destroy_n(new_data.GetAddress() + offset, count);
+            throw;
+        }
+
+        AdoptStorage(new_data);
+        size_ += count;
+    }
+
+    // Сдвигает хвост на count позиций один раз. size_ растёт по мере конструирования
+    // элементов за старым концом, так что при исключении вектор остаётся корректным
+    template <typename ForwardIt>
+    void InsertRangeWithoutReallocating(std::size_t offset, ForwardIt first, ForwardIt last, std::size_t count) {
+        T* pos = data_ + offset;
+        T* old_end = data_ + size_;
+        const std::size_t elems_after = size_ - offset;
+
+        stats_.OnInsertShift(elems_after);
+
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            std::memmove(static_cast<void*>(pos + count), pos, elems_after * sizeof(T));
+            try {
+                std::uninitialized_copy(first, last, pos);
+            } catch (...) {
+                std::memmove(static_cast<void*>(pos), pos + count, elems_after * sizeof(T));
+                throw;
+            }
+            size_ += count;
+
+        } else if (elems_after > count) {
+            std::uninitialized_move(old_end - count, old_end, old_end);
+            size_ += count;
+            std::move_backward(pos, old_end - count, old_end);
+            std::copy(first, last, pos);
+
+        } else {
+            ForwardIt mid = first;
+            std::advance(mid, elems_after);
+            std::uninitialized_copy(mid, last, old_end);
+            size_ += count - elems_after;
+            std::uninitialized_move(pos, old_end, pos + count);
+            size_ += elems_after;
+            std::copy(first, mid, pos);
+        }
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR void ReallocateStorage(size_t new_capacity) {
+        assert(new_capacity >= size_);
+
+        if constexpr (GROWS_IN_PLACE) {
+            ReallocateInPlace(new_capacity);
+        } else {
+            RawMemory<T, Alloc> new_data(new_capacity, data_.GetAllocator());
+            RelocateInto(new_data, size_, 0);
+            AdoptStorage(new_data);
+        }
+    }
+
+    // Вызывается после каждого удаления элементов.
+    // Автоматическое уменьшение включается политикой роста с методом ShrinkCapacity.
+    // Это лишь оптимизация, поэтому неудачная реаллокация оставляет буфер как есть
+    ADVANCED_VECTOR_CONSTEXPR void MaybeShrink() noexcept {
+        if constexpr (HasShrinkCapacity<Growth>::value) {
+            const size_t new_capacity = Growth::ShrinkCapacity(Capacity(), size_, sizeof(T));
+            if (new_capacity < Capacity()) {
+                try {
+                    ReallocateStorage(new_capacity);
+                } catch (...) {
+                }
+            }
+        }
+
+        ReportSize();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR void RelocateInto(RawMemory<T, Alloc>& new_data, std::size_t offset, std::size_t gap) {
+        UninitializedRelocate(data_.GetAddress(), size_, new_data.GetAddress(), offset, gap);
+        stats_.OnRelocate(size_, RELOCATION_KIND);
+    }
+
+    // Элементы уже перенесены в new_data; прежний буфер освобождается вместе с new_data
+    ADVANCED_VECTOR_CONSTEXPR void AdoptStorage(RawMemory<T, Alloc>& new_data) noexcept {
+        stats_.OnReallocate(Capacity(), new_data.Capacity(), sizeof(T));
         data_.Swap(new_data);
+        ReportSize();
+    }
+
+    void ReallocateInPlace(size_t new_capacity) {
+        const size_t old_capacity = Capacity();
+        data_.Reallocate(new_capacity);
+        stats_.OnReallocate(old_capacity, new_capacity, sizeof(T));
+        stats_.OnRelocate(size_, RelocationKind::BYTEWISE);
+        ReportSize();
+    }
+
+    // Временные векторы не ведут статистику: их буфер учитывается здесь как перевыделение
+    ADVANCED_VECTOR_CONSTEXPR void ReplaceWith(Untracked& replacement) noexcept {
+        stats_.OnReallocate(Capacity(), replacement.Capacity(), sizeof(T));
+        data_.Swap(replacement.data_);
+        std::swap(size_, replacement.size_);
+        ReportSize();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR void ReportSize() noexcept {
+        if constexpr (HasSizeHook<Stats>::value) {
+            stats_.OnSize(size_, sizeof(T));
+        }
     }
 
     template <typename... Args>
     void InsertWithoutReallocating(const_iterator pos, std::size_t offset, Args&&... args) {
         if (pos != cend()) {
-                    
+            stats_.OnInsertShift(size_ - offset);
+
             T temp(std::forward<Args>(args)...);                   
             new (end()) T(std::forward<T>(data_[size_ - 1]));
                     
-            std::move_backward(begin() + offset, end() - 1, end());                 
-            *(begin() + offset) = std::forward<T>(temp);
+            // Элемент за концом ещё не входит в size_, поэтому при исключении
+            // во время сдвига его нужно уничтожить здесь
+            try {
+                std::move_backward(begin() + offset, end() - 1, end());
+                *(begin() + offset) = std::forward<T>(temp);
+            } catch (...) {
+                std::destroy_at(end());
+                throw;
+            }
                     
         } else {
             new (end()) T(std::forward<Args>(args)...);
         }
     }
 
-    RawMemory<T> data_;
+    ADVANCED_VECTOR_CONSTEXPR size_t NextCapacity(size_t required) const noexcept {
+        return Growth::NewCapacity(Capacity(), required, sizeof(T));
+    }
+
+    void ParallelCopyConstruct(const ParallelPolicy& policy, const T* source, size_t count) {
+        assert(size_ == 0);
+
+        RawMemory<T, Alloc> new_data(count, data_.GetAllocator());
+        ParallelUninitializedCopyN(policy, source, count, new_data.GetAddress());
+        data_.Swap(new_data);
+        size_ = count;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR void SwapStorage(Vector& other) noexcept {
+        data_.Swap(other.data_);
+        std::swap(size_, other.size_);
+        std::swap(stats_, other.stats_);
+        ReportSize();
+        other.ReportSize();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR void MoveAssignElements(Vector& rhs) {
+        if (rhs.size_ > data_.Capacity()) {
+            RawMemory<T, Alloc> new_data(rhs.size_, data_.GetAllocator());
+            UninitializedMoveN(rhs.data_.GetAddress(), rhs.size_, new_data.GetAddress());
+            std::destroy_n(data_.GetAddress(), size_);
+            AdoptStorage(new_data);
+
+        } else {
+            std::size_t min = std::min(size_, rhs.size_);
+            std::move(rhs.data_.GetAddress(), rhs.data_ + min, data_.GetAddress());
+
+            if (size_ >= rhs.size_) {
+                std::destroy_n(data_ + rhs.size_, size_ - rhs.size_);
+            } else {
+                UninitializedMoveN(rhs.data_ + size_, rhs.size_ - size_, data_ + size_);
+            }
+        }
+
+        size_ = rhs.size_;
+        ReportSize();
+    }
+
+    RawMemory<T, Alloc> data_;
     size_t size_ = 0;
-};
\ No newline at end of file
+    [[no_unique_address]] Stats stats_;
+};
+
+template <typename T, typename Alloc, typename Growth, typename Stats, typename Pred>
+size_t EraseIf(Vector<T, Alloc, Growth, Stats>& v, Pred pred) {
+    return v.EraseIf(pred);
+}
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "vector.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <system_error>
+
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Двоичный формат вектора побайтово копируемых элементов: заголовок, за которым
+// без промежутков идут байты элементов. Порядок байт не преобразуется; файл,
+// записанный на машине с другим порядком, отвергается при чтении
+struct VectorIoHeader {
+    static constexpr std::uint32_t MAGIC = 0x43455641;  // "AVEC"
+    static constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    std::uint32_t magic = MAGIC;
+    std::uint32_t byte_order = BYTE_ORDER_MARK;
+    std::uint32_t element_size = 0;
+    std::uint32_t reserved = 0;
+    std::uint64_t count = 0;
+};
+
+static_assert(sizeof(VectorIoHeader) == 24);
+
+// Проверяет заголовок и возвращает число элементов
+template <typename T>
+size_t CheckVectorIoHeader(const VectorIoHeader& header) {
+    if (header.magic != VectorIoHeader::MAGIC) {
+        throw std::runtime_error("Not a serialized vector");
+    }
+    if (header.byte_order != VectorIoHeader::BYTE_ORDER_MARK) {
+        throw std::runtime_error("Serialized vector has a different byte order");
+    }
+    if (header.element_size != sizeof(T)) {
+        throw std::runtime_error("Serialized vector has a different element size");
+    }
+    if (header.count > static_cast<size_t>(-1) / sizeof(T)) {
+        throw std::runtime_error("Serialized vector is too large");
+    }
+    return static_cast<size_t>(header.count);
+}
+
+template <typename T, typename... Policies>
+VectorIoHeader MakeVectorIoHeader(const Vector<T, Policies...>& v) noexcept {
+    VectorIoHeader header;
+    header.element_size = sizeof(T);
+    header.count = v.Size();
+    return header;
+}
+
+// Записывает заголовки и элементы всех векторов одним вызовом writev,
+// повторяя его только при частичной записи
+template <typename... Vectors>
+void WriteTo(int fd, const Vectors&... vectors) {
+    static_assert(sizeof...(Vectors) > 0);
+    static_assert((std::is_trivially_copyable_v<typename Vectors::value_type> && ...),
+                  "Only vectors of trivially copyable elements can be written as bytes");
+
+    VectorIoHeader headers[] = {MakeVectorIoHeader(vectors)...};
+    iovec iov[2 * sizeof...(Vectors)];
+
+    size_t index = 0;
+    ((iov[2 * index] = {&headers[index], sizeof(VectorIoHeader)},
+      iov[2 * index + 1] = {const_cast<void*>(static_cast<const void*>(vectors.begin())),
+                            vectors.Size() * sizeof(typename Vectors::value_type)},
+      ++index), ...);
+
+    // writev принимает не больше IOV_MAX буферов, а здесь их заведомо немного
+    iovec* first = iov;
+    int remaining = static_cast<int>(2 * sizeof...(Vectors));
+    while (remaining > 0) {
+        const ssize_t written = writev(fd, first, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "writev");
+        }
+
+        size_t left = static_cast<size_t>(written);
+        while (remaining > 0 && left >= first->iov_len) {
+            left -= first->iov_len;
+            ++first;
+            --remaining;
+        }
+        if (remaining > 0) {
+            first->iov_base = static_cast<char*>(first->iov_base) + left;
+            first->iov_len -= left;
+        }
+    }
+}
+
+template <typename T, typename... Policies>
+void WriteTo(std::ostream& out, const Vector<T, Policies...>& v) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only vectors of trivially copyable elements can be written as bytes");
+
+    const VectorIoHeader header = MakeVectorIoHeader(v);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(v.begin()), static_cast<std::streamsize>(v.Size() * sizeof(T)));
+    if (!out) {
+        throw std::runtime_error("Failed to write a vector to the stream");
+    }
+}
+
+// Дочитывает ровно size байт; false означает, что файл кончился раньше
+inline bool ReadExactly(int fd, void* buffer, size_t size) {
+    char* p = static_cast<char*>(buffer);
+    while (size > 0) {
+        const ssize_t bytes = read(fd, p, size);
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "read");
+        }
+        if (bytes == 0) {
+            return false;
+        }
+        p += bytes;
+        size -= static_cast<size_t>(bytes);
+    }
+    return true;
+}
+
+// Длина входа неизвестна: канал, сокет или поток без позиционирования
+inline constexpr size_t UNKNOWN_INPUT_SIZE = static_cast<size_t>(-1);
+
+// Без известной длины входа вектор растёт по мере чтения, начиная с этого числа байт
+// и удваиваясь, так что испорченный заголовок не заставит выделить память
+// под элементы, которых во входе нет
+inline constexpr size_t VECTOR_IO_CHUNK_BYTES = size_t{1} << 20;
+
+// Читает count элементов в пустой вектор функцией read(buffer, bytes), которая
+// возвращает false, если вход кончился раньше. Когда известно, сколько байт
+// осталось во входе, count сверяется с ними до выделения буфера
+template <typename T, typename... Policies, typename Read>
+bool ReadElements(Vector<T, Policies...>& v, size_t count, size_t available, Read read) {
+    if (available != UNKNOWN_INPUT_SIZE) {
+        if (count > available / sizeof(T)) {
+            return false;
+        }
+        v.ResizeDefaultInit(count);
+        return read(v.begin(), count * sizeof(T));
+    }
+
+    const size_t chunk = std::max<size_t>(VECTOR_IO_CHUNK_BYTES / sizeof(T), 1);
+    while (v.Size() < count) {
+        const size_t done = v.Size();
+        v.ResizeDefaultInit(done + std::min(count - done, std::max(chunk, done)));
+        if (!read(v.begin() + done, (v.Size() - done) * sizeof(T))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Сколько байт осталось в обычном файле после текущей позиции
+inline size_t RemainingInputSize(int fd) {
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        return UNKNOWN_INPUT_SIZE;
+    }
+    const off_t position = lseek(fd, 0, SEEK_CUR);
+    if (position < 0) {
+        return UNKNOWN_INPUT_SIZE;
+    }
+    return info.st_size > position ? static_cast<size_t>(info.st_size - position) : 0;
+}
+
+inline size_t RemainingInputSize(std::istream& in) {
+    std::streambuf* buffer = in.rdbuf();
+    const std::streampos position = buffer->pubseekoff(0, std::ios::cur, std::ios::in);
+    if (position == std::streampos(-1)) {
+        return UNKNOWN_INPUT_SIZE;
+    }
+    const std::streampos end = buffer->pubseekoff(0, std::ios::end, std::ios::in);
+    buffer->pubseekpos(position, std::ios::in);
+    if (end == std::streampos(-1)) {
+        return UNKNOWN_INPUT_SIZE;
+    }
+    return end > position ? static_cast<size_t>(end - position) : 0;
+}
+
+// Заменяет содержимое векторов прочитанным, и байты читаются прямо в их буферы.
+// Для обычного файла буфер каждого вектора выделяется не больше одного раза, и
+// заголовок, обещающий больше элементов, чем осталось в файле, отвергается до
+// выделения. При ошибке вектор, на котором она произошла, остаётся пустым
+template <typename T, typename... Policies, typename... Vectors>
+void ReadFrom(int fd, Vector<T, Policies...>& v, Vectors&... rest) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only vectors of trivially copyable elements can be read as bytes");
+
+    VectorIoHeader header;
+    if (!ReadExactly(fd, &header, sizeof(header))) {
+        throw std::runtime_error("Unexpected end of file in a vector header");
+    }
+
+    v.Clear();
+    const size_t count = CheckVectorIoHeader<T>(header);
+    if (!ReadElements(v, count, RemainingInputSize(fd), [fd](void* buffer, size_t size) {
+            return ReadExactly(fd, buffer, size);
+        })) {
+        v.Clear();
+        throw std::runtime_error("Unexpected end of file in vector elements");
+    }
+
+    if constexpr (sizeof...(Vectors) > 0) {
+        ReadFrom(fd, rest...);
+    }
+}
+
+template <typename T, typename... Policies>
+void ReadFrom(std::istream& in, Vector<T, Policies...>& v) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only vectors of trivially copyable elements can be read as bytes");
+
+    VectorIoHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::runtime_error("Unexpected end of stream in a vector header");
+    }
+
+    v.Clear();
+    const size_t count = CheckVectorIoHeader<T>(header);
+    if (!ReadElements(v, count, RemainingInputSize(in), [&in](void* buffer, size_t size) {
+            return static_cast<bool>(in.read(static_cast<char*>(buffer), static_cast<std::streamsize>(size)));
+        })) {
+        v.Clear();
+        throw std::runtime_error("Unexpected end of stream in vector elements");
+    }
+}
+
+#ifdef __cpp_lib_span
+// Представление сериализованного вектора, лежащего в чужом буфере, без копирования.
+// Буфер должен быть выровнен для T и жить дольше возвращённого span.
+// Элементы начинаются сразу за заголовком, остаток буфера после них возвращается в rest
+template <typename T>
+std::span<const T> ViewVector(std::span<const std::byte> buffer, std::span<const std::byte>* rest = nullptr) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be viewed as bytes");
+    static_assert(alignof(T) <= alignof(VectorIoHeader), "Elements after the header would be misaligned");
+
+    VectorIoHeader header;
+    if (buffer.size() < sizeof(header)) {
+        throw std::runtime_error("Buffer is too small for a vector header");
+    }
+    std::memcpy(&header, buffer.data(), sizeof(header));
+
+    const size_t count = CheckVectorIoHeader<T>(header);
+    const std::byte* elements = buffer.data() + sizeof(header);
+    if (count > (buffer.size() - sizeof(header)) / sizeof(T)) {
+        throw std::runtime_error("Buffer is too small for the vector elements");
+    }
+    if (reinterpret_cast<uintptr_t>(elements) % alignof(T) != 0) {
+        throw std::runtime_error("Buffer is not aligned for the vector elements");
+    }
+
+    if (rest != nullptr) {
+        *rest = buffer.subspan(sizeof(header) + count * sizeof(T));
+    }
+    return std::span<const T>(reinterpret_cast<const T*>(elements), count);
+}
+#endif
@@ -0,0 +1,381 @@
+#pragma once
+
+#include "vector.h"
+
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <utility>
+
+// Снимок счётчиков политики статистики Vector
+struct VectorStatsSnapshot {
+    size_t reallocations = 0;
+    size_t bytes_allocated = 0;
+    size_t bytes_freed = 0;
+    size_t elements_relocated = 0;  // перенесены побайтово (memcpy или realloc)
+    size_t elements_moved = 0;
+    size_t elements_copied = 0;
+    size_t peak_capacity = 0;
+    size_t inserts = 0;
+    size_t insert_shift = 0;        // сколько элементов сдвинуто вставками
+    size_t erases = 0;
+    size_t erase_shift = 0;         // сколько элементов сдвинуто удалениями
+};
+
+// Счётчики, принадлежащие одному вектору: Vector<T, Alloc, Growth, VectorStats>
+class VectorStats {
+public:
+    void OnAllocate(size_t capacity, size_t element_size) noexcept {
+        stats_.bytes_allocated += capacity * element_size;
+        stats_.peak_capacity = std::max(stats_.peak_capacity, capacity);
+    }
+
+    void OnDeallocate(size_t capacity, size_t element_size) noexcept {
+        stats_.bytes_freed += capacity * element_size;
+    }
+
+    void OnReallocate(size_t old_capacity, size_t new_capacity, size_t element_size) noexcept {
+        ++stats_.reallocations;
+        OnAllocate(new_capacity, element_size);
+        OnDeallocate(old_capacity, element_size);
+    }
+
+    void OnRelocate(size_t count, RelocationKind kind) noexcept {
+        switch (kind) {
+        case RelocationKind::BYTEWISE:
+            stats_.elements_relocated += count;
+            break;
+        case RelocationKind::MOVE:
+            stats_.elements_moved += count;
+            break;
+        case RelocationKind::COPY:
+            stats_.elements_copied += count;
+            break;
+        }
+    }
+
+    void OnInsertShift(size_t count) noexcept {
+        ++stats_.inserts;
+        stats_.insert_shift += count;
+    }
+
+    void OnEraseShift(size_t count) noexcept {
+        ++stats_.erases;
+        stats_.erase_shift += count;
+    }
+
+    VectorStatsSnapshot Snapshot() const noexcept {
+        return stats_;
+    }
+
+private:
+    VectorStatsSnapshot stats_;
+};
+
+// Счётчики, общие для всех векторов, объявленных с одним Tag. Удобно завести
+// свой Tag на каждое место создания вектора и сравнивать их между собой.
+// Счётчики атомарные, с relaxed-порядком: каждый из них точен, но снимок,
+// снятый во время работы других потоков, не обязан быть согласованным
+template <typename Tag>
+class SharedVectorStats {
+public:
+    void OnAllocate(size_t capacity, size_t element_size) noexcept {
+        Add(bytes_allocated_, capacity * element_size);
+        size_t peak = peak_capacity_.load(std::memory_order_relaxed);
+        while (peak < capacity
+               && !peak_capacity_.compare_exchange_weak(peak, capacity, std::memory_order_relaxed)) {
+        }
+    }
+
+    void OnDeallocate(size_t capacity, size_t element_size) noexcept {
+        Add(bytes_freed_, capacity * element_size);
+    }
+
+    void OnReallocate(size_t old_capacity, size_t new_capacity, size_t element_size) noexcept {
+        Add(reallocations_, 1);
+        OnAllocate(new_capacity, element_size);
+        OnDeallocate(old_capacity, element_size);
+    }
+
+    void OnRelocate(size_t count, RelocationKind kind) noexcept {
+        switch (kind) {
+        case RelocationKind::BYTEWISE:
+            Add(elements_relocated_, count);
+            break;
+        case RelocationKind::MOVE:
+            Add(elements_moved_, count);
+            break;
+        case RelocationKind::COPY:
+            Add(elements_copied_, count);
+            break;
+        }
+    }
+
+    void OnInsertShift(size_t count) noexcept {
+        Add(inserts_, 1);
+        Add(insert_shift_, count);
+    }
+
+    void OnEraseShift(size_t count) noexcept {
+        Add(erases_, 1);
+        Add(erase_shift_, count);
+    }
+
+    static VectorStatsSnapshot Snapshot() noexcept {
+        VectorStatsSnapshot snapshot;
+        snapshot.reallocations = reallocations_.load(std::memory_order_relaxed);
+        snapshot.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed);
+        snapshot.bytes_freed = bytes_freed_.load(std::memory_order_relaxed);
+        snapshot.elements_relocated = elements_relocated_.load(std::memory_order_relaxed);
+        snapshot.elements_moved = elements_moved_.load(std::memory_order_relaxed);
+        snapshot.elements_copied = elements_copied_.load(std::memory_order_relaxed);
+        snapshot.peak_capacity = peak_capacity_.load(std::memory_order_relaxed);
+        snapshot.inserts = inserts_.load(std::memory_order_relaxed);
+        snapshot.insert_shift = insert_shift_.load(std::memory_order_relaxed);
+        snapshot.erases = erases_.load(std::memory_order_relaxed);
+        snapshot.erase_shift = erase_shift_.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    static void Reset() noexcept {
+        for (std::atomic<size_t>* counter : {&reallocations_, &bytes_allocated_, &bytes_freed_,
+                                             &elements_relocated_, &elements_moved_, &elements_copied_,
+                                             &peak_capacity_, &inserts_, &insert_shift_, &erases_,
+                                             &erase_shift_}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    static void Add(std::atomic<size_t>& counter, size_t value) noexcept {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    inline static std::atomic<size_t> reallocations_{0};
+    inline static std::atomic<size_t> bytes_allocated_{0};
+    inline static std::atomic<size_t> bytes_freed_{0};
+    inline static std::atomic<size_t> elements_relocated_{0};
+    inline static std::atomic<size_t> elements_moved_{0};
+    inline static std::atomic<size_t> elements_copied_{0};
+    inline static std::atomic<size_t> peak_capacity_{0};
+    inline static std::atomic<size_t> inserts_{0};
+    inline static std::atomic<size_t> insert_shift_{0};
+    inline static std::atomic<size_t> erases_{0};
+    inline static std::atomic<size_t> erase_shift_{0};
+};
+
+// Счётчики одного Tag в глобальном реестре
+struct VectorRegistryRecord {
+    const char* name = nullptr;
+    size_t live_vectors = 0;
+    size_t live_bytes = 0;
+    // Незанятая ёмкость (Capacity() - Size()) * sizeof(T) всех векторов,
+    // вычисленная в момент снимка
+    size_t slack_bytes = 0;
+};
+
+// Глобальный реестр векторов с политикой RegisteredVectorStats. Записи добавляются
+// при первом использовании Tag и живут до конца программы, поэтому Snapshot
+// и Dump можно вызывать из любого потока в любой момент
+class VectorRegistry {
+public:
+    // Занятые байты одного вектора. Пишет их только сам вектор, а читает снимок
+    struct TrackedVector {
+        std::atomic<size_t> used_bytes{0};
+        TrackedVector* prev = nullptr;
+        TrackedVector* next = nullptr;
+    };
+
+    class alignas(64) Entry {
+    public:
+        explicit Entry(const char* name) noexcept
+            : name_(name)
+            , next_(head_.load(std::memory_order_relaxed))
+        {
+            while (!head_.compare_exchange_weak(next_, this, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        }
+
+        Entry(const Entry&) = delete;
+        Entry& operator=(const Entry&) = delete;
+
+        std::atomic<size_t> live_vectors{0};
+        std::atomic<size_t> live_bytes{0};
+
+        // Список векторов, у которых появлялся буфер. Снимок складывает их занятые байты
+        void Track(TrackedVector& vector) noexcept {
+            std::lock_guard guard(mutex_);
+            vector.next = tracked_;
+            if (tracked_ != nullptr) {
+                tracked_->prev = &vector;
+            }
+            tracked_ = &vector;
+        }
+
+        void Untrack(TrackedVector& vector) noexcept {
+            std::lock_guard guard(mutex_);
+            (vector.prev != nullptr ? vector.prev->next : tracked_) = vector.next;
+            if (vector.next != nullptr) {
+                vector.next->prev = vector.prev;
+            }
+        }
+
+    private:
+        friend class VectorRegistry;
+
+        size_t UsedBytes() const noexcept {
+            std::lock_guard guard(mutex_);
+            size_t bytes = 0;
+            for (const TrackedVector* vector = tracked_; vector != nullptr; vector = vector->next) {
+                bytes += vector->used_bytes.load(std::memory_order_relaxed);
+            }
+            return bytes;
+        }
+
+        const char* name_;
+        Entry* next_;
+        mutable std::mutex mutex_;
+        TrackedVector* tracked_ = nullptr;
+    };
+
+    // Записи в порядке, обратном регистрации. Каждый счётчик точен, но снимок,
+    // снятый во время работы других потоков, не обязан быть согласованным
+    static Vector<VectorRegistryRecord> Snapshot() {
+        Vector<VectorRegistryRecord> records;
+        for (const Entry* entry = head_.load(std::memory_order_acquire); entry != nullptr; entry = entry->next_) {
+            records.PushBack(Read(*entry));
+        }
+        return records;
+    }
+
+    static VectorRegistryRecord Snapshot(const Entry& entry) noexcept {
+        return Read(entry);
+    }
+
+    // Строка на каждый Tag: имя vectors=N live_bytes=B slack_bytes=S
+    static void Dump(std::ostream& out) {
+        for (const VectorRegistryRecord& record : Snapshot()) {
+            out << record.name << " vectors=" << record.live_vectors << " live_bytes=" << record.live_bytes
+                << " slack_bytes=" << record.slack_bytes << '\n';
+        }
+    }
+
+private:
+    static VectorRegistryRecord Read(const Entry& entry) noexcept {
+        VectorRegistryRecord record;
+        record.name = entry.name_;
+        record.live_vectors = entry.live_vectors.load(std::memory_order_relaxed);
+        record.live_bytes = entry.live_bytes.load(std::memory_order_relaxed);
+        // Во время работы других потоков занятые байты могут оказаться новее live_bytes
+        const size_t used_bytes = entry.UsedBytes();
+        record.slack_bytes = record.live_bytes > used_bytes ? record.live_bytes - used_bytes : 0;
+        return record;
+    }
+
+    inline static std::atomic<Entry*> head_{nullptr};
+};
+
+// Политика, учитывающая векторы в VectorRegistry под именем Tag::NAME. Заводится
+// по Tag на каждое место создания векторов, за которыми нужно следить.
+// Выделение и освобождение буфера стоят одного relaxed-сложения для занятых байтов.
+// Вектор, впервые получивший буфер, один раз встаёт в список записи под её мьютексом
+// и покидает его при уничтожении. Изменение размера стоит одной relaxed-записи
+// в собственный счётчик вектора, а незанятые байты считаются по списку
+// в Snapshot и Dump. Счётчики байтов точны по Tag в целом,
+// поскольку буфер переходит между векторами только с одним Tag
+template <typename Tag>
+class RegisteredVectorStats {
+public:
+    RegisteredVectorStats() noexcept {
+        Add(GetEntry().live_vectors, 1);
+    }
+
+    // Копия вектора получает свой буфер и сама сообщит о нём
+    RegisteredVectorStats(const RegisteredVectorStats& /*other*/) noexcept
+        : RegisteredVectorStats()
+    {}
+
+    // Перемещение вектора передаёт буфер вместе с его занятыми байтами
+    RegisteredVectorStats(RegisteredVectorStats&& other) noexcept
+        : RegisteredVectorStats()
+    {
+        TakeUsedBytes(other);
+    }
+
+    RegisteredVectorStats& operator=(const RegisteredVectorStats& /*rhs*/) noexcept {
+        return *this;
+    }
+
+    RegisteredVectorStats& operator=(RegisteredVectorStats&& rhs) noexcept {
+        if (this != &rhs) {
+            TakeUsedBytes(rhs);
+        }
+        return *this;
+    }
+
+    ~RegisteredVectorStats() {
+        Add(GetEntry().live_vectors, 0 - size_t{1});
+        if (tracked_) {
+            GetEntry().Untrack(node_);
+        }
+    }
+
+    void OnAllocate(size_t capacity, size_t element_size) noexcept {
+        Add(GetEntry().live_bytes, capacity * element_size);
+        if (capacity != 0) {
+            Track();
+        }
+    }
+
+    void OnDeallocate(size_t capacity, size_t element_size) noexcept {
+        Add(GetEntry().live_bytes, 0 - capacity * element_size);
+    }
+
+    // Беззнаковое вычитание по модулю даёт верную разность и при уменьшении буфера
+    void OnReallocate(size_t old_capacity, size_t new_capacity, size_t element_size) noexcept {
+        Add(GetEntry().live_bytes, new_capacity * element_size - old_capacity * element_size);
+        if (new_capacity != 0) {
+            Track();
+        }
+    }
+
+    void OnSize(size_t size, size_t element_size) noexcept {
+        node_.used_bytes.store(size * element_size, std::memory_order_relaxed);
+    }
+
+    constexpr void OnRelocate(size_t /*count*/, RelocationKind /*kind*/) noexcept {}
+    constexpr void OnInsertShift(size_t /*count*/) noexcept {}
+    constexpr void OnEraseShift(size_t /*count*/) noexcept {}
+
+    static VectorRegistryRecord Snapshot() noexcept {
+        return VectorRegistry::Snapshot(GetEntry());
+    }
+
+private:
+    static VectorRegistry::Entry& GetEntry() noexcept {
+        static VectorRegistry::Entry entry(Tag::NAME);
+        return entry;
+    }
+
+    static void Add(std::atomic<size_t>& counter, size_t value) noexcept {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    void Track() noexcept {
+        if (!tracked_) {
+            GetEntry().Track(node_);
+            tracked_ = true;
+        }
+    }
+
+    void TakeUsedBytes(RegisteredVectorStats& other) noexcept {
+        node_.used_bytes.store(other.node_.used_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        other.node_.used_bytes.store(0, std::memory_order_relaxed);
+        if (other.tracked_) {
+            Track();
+        }
+    }
+
+    VectorRegistry::TrackedVector node_;
+    bool tracked_ = false;
+};